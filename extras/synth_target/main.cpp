@@ -0,0 +1,440 @@
+// A process with a known population of objects to benchmark and validate ReGenny's scans against. Everything it
+// allocates is described by a JSON manifest, so the results of a type search, RTTI sweep, census or walker can be
+// checked against ground truth. The same seed always produces the same population (addresses aside).
+//
+// Usage: regenny_synth_target [--objects N] [--seed N] [--tree-depth N] [--ring N] [--strings N] [--samples N]
+//                             [--manifest PATH] [--exit-after SECONDS]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <optional>
+#include <random>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <typeinfo>
+#include <unordered_map>
+#include <vector>
+
+#ifdef _WIN32
+#include <process.h>
+#define getpid _getpid
+#else
+#include <unistd.h>
+#endif
+
+namespace synth {
+// "SYNT", the first field of every object so scanners can cheaply confirm a hit.
+constexpr uint32_t object_magic = 0x544E5953;
+constexpr int max_depth = 8;
+
+struct Object {
+    uint32_t magic{object_magic};
+    uint32_t id{};
+    // The next instance of the same class (in allocation order), null terminated.
+    Object* next{};
+    // A random instance of any class. These make the pointer graph full of cycles.
+    Object* peer{};
+
+    virtual ~Object() = default;
+    virtual int depth() const { return 0; }
+};
+
+// Level<N> derives from Level<N - 1> and adds N fields, so every level has its own size.
+template <int N> struct Level : Level<N - 1> {
+    uint64_t values[N]{};
+
+    int depth() const override { return N; }
+};
+
+template <> struct Level<0> : Object {};
+
+struct Mixin {
+    uint32_t mixin_tag{0x4D495846};
+
+    virtual ~Mixin() = default;
+};
+
+// A second vtable at a non-zero offset.
+struct Multi : Level<3>, Mixin {
+    uint64_t multi_value{};
+};
+
+struct Named : Level<1> {
+    std::string name{};
+};
+
+// The links are laid out for ReGenny's [[tree:left:right]] walker.
+struct TreeNode : Object {
+    TreeNode* left{};
+    TreeNode* right{};
+    int64_t key{};
+};
+
+// next forms a cycle.
+struct RingNode : Object {
+    uint64_t position{};
+};
+
+struct Container : Object {
+    std::vector<Object*> children{};
+    std::map<uint32_t, Object*> by_id{};
+    std::unordered_map<std::string, Object*> by_name{};
+};
+
+struct Class {
+    std::string name{};
+    std::string base{};
+    size_t size{};
+    // Relative weight in the random population. 0 for classes that are only made on purpose (trees, rings...).
+    uint32_t weight{};
+    Object* (*make)(){};
+    std::vector<Object*> instances{};
+};
+
+template <typename T> Object* make() {
+    return new T{};
+}
+
+template <int N> void add_levels(std::vector<Class>& classes) {
+    if constexpr (N > 0) {
+        add_levels<N - 1>(classes);
+    }
+
+    auto base = N == 0 ? std::string{"synth::Object"} : "synth::Level<" + std::to_string(N - 1) + ">";
+    auto name = "synth::Level<" + std::to_string(N) + ">";
+    classes.emplace_back(name, base, sizeof(Level<N>), (uint32_t)(max_depth + 1 - N), &make<Level<N>>);
+}
+
+struct Options {
+    size_t objects{1'000'000};
+    uint64_t seed{1};
+    int tree_depth{16};
+    size_t ring{1000};
+    size_t strings{10'000};
+    size_t samples{64};
+    std::filesystem::path manifest{"synth_target.json"};
+    int exit_after{};
+};
+
+std::string hex(uintptr_t value) {
+    char buf[32]{};
+    snprintf(buf, sizeof(buf), "\"0x%llX\"", (unsigned long long)value);
+    return buf;
+}
+
+std::string quote(std::string_view s) {
+    std::string out{"\""};
+
+    for (auto c : s) {
+        if (c == '"' || c == '\\') {
+            out += '\\';
+        }
+
+        out += c;
+    }
+
+    return out + '"';
+}
+
+uintptr_t vtable_of(const void* obj) {
+    return *(const uintptr_t*)obj;
+}
+
+template <typename T, typename F> size_t offset_of(const T* obj, const F* field) {
+    return (uintptr_t)field - (uintptr_t)obj;
+}
+
+// A complete binary search tree over [lo, hi].
+TreeNode* make_tree(std::vector<TreeNode*>& nodes, int depth, int64_t lo, int64_t hi) {
+    if (depth == 0) {
+        return nullptr;
+    }
+
+    auto node = new TreeNode{};
+    auto mid = lo + (hi - lo) / 2;
+
+    node->key = mid;
+    nodes.emplace_back(node);
+    node->left = make_tree(nodes, depth - 1, lo, mid);
+    node->right = make_tree(nodes, depth - 1, mid + 1, hi);
+
+    return node;
+}
+
+std::optional<Options> parse_options(int argc, char** argv) {
+    Options opts{};
+
+    for (int i = 1; i < argc; ++i) {
+        std::string_view arg{argv[i]};
+
+        if (i + 1 >= argc) {
+            fprintf(stderr, "missing value for %s\n", argv[i]);
+            return std::nullopt;
+        }
+
+        std::string value{argv[++i]};
+
+        if (arg == "--objects") {
+            opts.objects = std::stoull(value);
+        } else if (arg == "--seed") {
+            opts.seed = std::stoull(value);
+        } else if (arg == "--tree-depth") {
+            opts.tree_depth = std::clamp(std::stoi(value), 0, 24);
+        } else if (arg == "--ring") {
+            opts.ring = std::stoull(value);
+        } else if (arg == "--strings") {
+            opts.strings = std::stoull(value);
+        } else if (arg == "--samples") {
+            opts.samples = std::stoull(value);
+        } else if (arg == "--manifest") {
+            opts.manifest = value;
+        } else if (arg == "--exit-after") {
+            opts.exit_after = std::stoi(value);
+        } else {
+            fprintf(stderr, "unknown option %s\n", argv[i - 1]);
+            return std::nullopt;
+        }
+    }
+
+    return opts;
+}
+} // namespace synth
+
+using namespace synth;
+
+int main(int argc, char** argv) {
+    std::optional<Options> parsed{};
+
+    try {
+        parsed = parse_options(argc, argv);
+    } catch (const std::exception& e) {
+        fprintf(stderr, "bad option: %s\n", e.what());
+    }
+
+    if (!parsed) {
+        return 1;
+    }
+
+    auto& opts = *parsed;
+    std::mt19937_64 rng{opts.seed};
+    auto start_time = std::chrono::steady_clock::now();
+
+    std::vector<Class> classes{};
+    add_levels<max_depth>(classes);
+    classes.emplace_back("synth::Multi", "synth::Level<3>", sizeof(Multi), 2, &make<Multi>);
+    classes.emplace_back("synth::Named", "synth::Level<1>", sizeof(Named), 0, &make<Named>);
+    classes.emplace_back("synth::TreeNode", "synth::Object", sizeof(TreeNode), 0, &make<TreeNode>);
+    classes.emplace_back("synth::RingNode", "synth::Object", sizeof(RingNode), 0, &make<RingNode>);
+    classes.emplace_back("synth::Container", "synth::Object", sizeof(Container), 0, &make<Container>);
+
+    auto class_index = [&](std::string_view name) {
+        return (size_t)(std::find_if(classes.begin(), classes.end(), [&](auto&& c) { return c.name == name; }) -
+                        classes.begin());
+    };
+
+    // The random population. Classes are interleaved in the heap like a real program's would be. The picks use the raw
+    // generator rather than a std distribution so the same seed gives the same population with any standard library.
+    uint64_t total_weight{};
+
+    for (auto&& c : classes) {
+        total_weight += c.weight;
+    }
+
+    std::vector<Object*> all{};
+    all.reserve(opts.objects + opts.strings + opts.ring + ((size_t)1 << opts.tree_depth) + 1);
+
+    for (size_t i = 0; i < opts.objects; ++i) {
+        auto pick = rng() % total_weight;
+        auto it = classes.begin();
+
+        while (pick >= it->weight) {
+            pick -= it->weight;
+            ++it;
+        }
+
+        auto obj = it->make();
+        obj->id = (uint32_t)all.size();
+
+        if (auto level = dynamic_cast<Level<1>*>(obj)) {
+            level->values[0] = rng();
+        }
+
+        it->instances.emplace_back(obj);
+        all.emplace_back(obj);
+    }
+
+    // Strings alternate between ones that fit the small string buffer and ones that live on the heap.
+    auto& named = classes[class_index("synth::Named")];
+
+    for (size_t i = 0; i < opts.strings; ++i) {
+        auto obj = new Named{};
+        obj->id = (uint32_t)all.size();
+        obj->name = i % 2 == 0 ? "s" + std::to_string(i) : "synth string #" + std::to_string(i) + " lives on the heap";
+        named.instances.emplace_back(obj);
+        all.emplace_back(obj);
+    }
+
+    auto& ring = classes[class_index("synth::RingNode")];
+
+    for (size_t i = 0; i < opts.ring; ++i) {
+        auto obj = new RingNode{};
+        obj->id = (uint32_t)all.size();
+        obj->position = i;
+        ring.instances.emplace_back(obj);
+        all.emplace_back(obj);
+    }
+
+    std::vector<TreeNode*> tree_nodes{};
+    auto tree_root = make_tree(tree_nodes, opts.tree_depth, 0, ((int64_t)1 << opts.tree_depth) - 1);
+    auto& trees = classes[class_index("synth::TreeNode")];
+
+    for (auto node : tree_nodes) {
+        node->id = (uint32_t)all.size();
+        trees.instances.emplace_back(node);
+        all.emplace_back(node);
+    }
+
+    // Link every class' instances into a list, except the ring which links back to its start.
+    for (auto&& c : classes) {
+        for (size_t i = 0; i + 1 < c.instances.size(); ++i) {
+            c.instances[i]->next = c.instances[i + 1];
+        }
+    }
+
+    if (!ring.instances.empty()) {
+        ring.instances.back()->next = ring.instances.front();
+    }
+
+    for (auto obj : all) {
+        obj->peer = all[rng() % all.size()];
+    }
+
+    auto container = new Container{};
+    container->id = (uint32_t)all.size();
+    classes[class_index("synth::Container")].instances.emplace_back(container);
+
+    for (size_t i = 0; i < std::min(opts.samples, all.size()); ++i) {
+        auto obj = all[rng() % all.size()];
+        container->children.emplace_back(obj);
+        container->by_id[obj->id] = obj;
+    }
+
+    for (size_t i = 0; i < std::min(opts.samples, named.instances.size()); ++i) {
+        auto obj = (Named*)named.instances[i];
+        container->by_name[obj->name] = obj;
+    }
+
+    all.emplace_back(container);
+
+    // Write the manifest next to a temporary and rename it over so a reader never sees half of it.
+    auto tmp_path = opts.manifest;
+    tmp_path += ".tmp";
+
+    {
+        std::ofstream f{tmp_path};
+
+        f << "{\n";
+        f << "  \"pid\": " << getpid() << ",\n";
+        f << "  \"pointer_size\": " << sizeof(void*) << ",\n";
+        f << "  \"seed\": " << opts.seed << ",\n";
+        f << "  \"magic\": " << hex(object_magic) << ",\n";
+        f << "  \"objects\": " << all.size() << ",\n";
+        f << "  \"classes\": [\n";
+
+        for (size_t i = 0; i < classes.size(); ++i) {
+            auto& c = classes[i];
+            f << "    {\"name\": " << quote(c.name) << ", \"base\": " << quote(c.base) << ", \"size\": " << c.size;
+
+            if (!c.instances.empty()) {
+                auto obj = c.instances.front();
+                f << ", \"rtti\": " << quote(typeid(*obj).name()) << ", \"vtable\": " << hex(vtable_of(obj));
+
+                if (auto multi = dynamic_cast<Multi*>(obj)) {
+                    auto mixin = static_cast<Mixin*>(multi);
+                    f << ", \"secondary_vtables\": [{\"offset\": " << offset_of(multi, mixin)
+                      << ", \"vtable\": " << hex(vtable_of(mixin)) << "}]";
+                }
+
+                f << ", \"head\": " << hex((uintptr_t)obj);
+            }
+
+            f << ", \"count\": " << c.instances.size() << ", \"samples\": [";
+
+            for (size_t j = 0; j < std::min(opts.samples, c.instances.size()); ++j) {
+                // Spread the samples over the whole population rather than the first few allocations.
+                auto obj = c.instances[j * c.instances.size() / std::min(opts.samples, c.instances.size())];
+                f << (j == 0 ? "" : ", ") << hex((uintptr_t)obj);
+            }
+
+            f << "]}" << (i + 1 < classes.size() ? "," : "") << "\n";
+        }
+
+        f << "  ],\n";
+
+        Multi multi{};
+        Named named_layout{};
+        TreeNode tree_layout{};
+        RingNode ring_layout{};
+        Object* object = &multi;
+
+        f << "  \"layout\": {\n";
+        f << "    \"synth::Object\": {\"magic\": " << offset_of(object, &object->magic)
+          << ", \"id\": " << offset_of(object, &object->id) << ", \"next\": " << offset_of(object, &object->next)
+          << ", \"peer\": " << offset_of(object, &object->peer) << "},\n";
+        f << "    \"synth::Multi\": {\"mixin\": " << offset_of(&multi, static_cast<Mixin*>(&multi))
+          << ", \"multi_value\": " << offset_of(&multi, &multi.multi_value) << "},\n";
+        f << "    \"synth::Named\": {\"name\": " << offset_of(&named_layout, &named_layout.name) << "},\n";
+        f << "    \"synth::TreeNode\": {\"left\": " << offset_of(&tree_layout, &tree_layout.left)
+          << ", \"right\": " << offset_of(&tree_layout, &tree_layout.right)
+          << ", \"key\": " << offset_of(&tree_layout, &tree_layout.key) << "},\n";
+        f << "    \"synth::RingNode\": {\"position\": " << offset_of(&ring_layout, &ring_layout.position) << "}\n";
+        f << "  },\n";
+
+        f << "  \"roots\": {\n";
+        f << "    \"tree\": {\"root\": " << hex((uintptr_t)tree_root) << ", \"nodes\": " << tree_nodes.size()
+          << ", \"depth\": " << opts.tree_depth << "},\n";
+        f << "    \"ring\": {\"head\": " << hex(ring.instances.empty() ? 0 : (uintptr_t)ring.instances.front())
+          << ", \"length\": " << ring.instances.size() << "},\n";
+        f << "    \"container\": {\"address\": " << hex((uintptr_t)container)
+          << ", \"children\": " << container->children.size() << ", \"by_id\": " << container->by_id.size()
+          << ", \"by_name\": " << container->by_name.size() << "}\n";
+        f << "  },\n";
+
+        f << "  \"strings\": [";
+
+        for (size_t i = 0; i < std::min(opts.samples, named.instances.size()); ++i) {
+            auto obj = (Named*)named.instances[i];
+            f << (i == 0 ? "\n" : ",\n") << "    {\"object\": " << hex((uintptr_t)obj)
+              << ", \"data\": " << hex((uintptr_t)obj->name.data()) << ", \"value\": " << quote(obj->name) << "}";
+        }
+
+        f << "\n  ]\n";
+        f << "}\n";
+
+        if (!f) {
+            fprintf(stderr, "failed to write %s\n", tmp_path.string().c_str());
+            return 1;
+        }
+    }
+
+    std::filesystem::rename(tmp_path, opts.manifest);
+
+    printf("%zu objects in %.2fs, manifest written to %s\n", all.size(),
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count(),
+        opts.manifest.string().c_str());
+    fflush(stdout);
+
+    // Stay alive to be inspected. Nothing is freed, the OS gets it all back.
+    for (auto elapsed = 0; opts.exit_after == 0 || elapsed < opts.exit_after; ++elapsed) {
+        std::this_thread::sleep_for(std::chrono::seconds{1});
+    }
+
+    return 0;
+}
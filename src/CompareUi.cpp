@@ -0,0 +1,396 @@
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <sstream>
+
+#include <fmt/format.h>
+#include <imgui.h>
+#include <imgui_stdlib.h>
+#include <spdlog/spdlog.h>
+
+#include "Utility.hpp"
+
+#include "CompareUi.hpp"
+
+void CompareUi::ui(Process& process, sdkgenny::Struct* struct_, uintptr_t address) {
+    if (struct_ == nullptr || struct_->size() == 0) {
+        ImGui::Text("Error: No Type");
+        return;
+    }
+
+    if (m_struct != struct_) {
+        m_struct = struct_;
+        m_array_stride = (int)struct_->size();
+        m_instances.clear();
+        m_columns.clear();
+        m_display_order.clear();
+    }
+
+    if (ImGui::RadioButton("Addresses", m_source == Source::Addresses)) {
+        m_source = Source::Addresses;
+    }
+
+    ImGui::SameLine();
+
+    if (ImGui::RadioButton("Array range", m_source == Source::ArrayRange)) {
+        m_source = Source::ArrayRange;
+    }
+
+    if (m_source == Source::Addresses) {
+        ImGui::InputTextMultiline("##compare_addresses", &m_addresses_text, ImVec2{-1.0f, 96.0f});
+        ImGui::TextDisabled("One instance per line: <address> [label]");
+
+        if (ImGui::Button("Add Current Address")) {
+            m_addresses_text += fmt::format("0x{:X}\n", address);
+        }
+    } else {
+        ImGui::InputText("Base", &m_array_base);
+        ImGui::SameLine();
+
+        if (ImGui::Button("Current")) {
+            m_array_base = fmt::format("0x{:X}", address);
+        }
+
+        ImGui::InputInt("Stride", &m_array_stride);
+        ImGui::InputInt("Count", &m_array_count);
+        m_array_stride = std::max(m_array_stride, 1);
+        m_array_count = std::clamp(m_array_count, 1, 4096);
+    }
+
+    constexpr int widths[] = {1, 2, 4, 8};
+
+    if (ImGui::BeginCombo("Width", fmt::format("{} bytes", m_width).c_str())) {
+        for (auto width : widths) {
+            if (ImGui::Selectable(fmt::format("{} bytes", width).c_str(), width == m_width)) {
+                m_width = width;
+                analyze();
+            }
+        }
+
+        ImGui::EndCombo();
+    }
+
+    ImGui::SameLine();
+    ImGui::BeginDisabled(m_width < 4);
+
+    if (ImGui::Checkbox("As float", &m_as_float)) {
+        analyze();
+    }
+
+    ImGui::EndDisabled();
+
+    if (ImGui::Button("Read Instances")) {
+        read_instances(process);
+        analyze();
+    }
+
+    if (m_instances.empty()) {
+        return;
+    }
+
+    ImGui::SameLine();
+    ImGui::Checkbox("Rank by correlation", &m_rank);
+    ImGui::SameLine();
+    ImGui::Checkbox("Only differing", &m_only_differing);
+
+    if (ImGui::TreeNode("Labels")) {
+        for (size_t i = 0; i < m_instances.size(); ++i) {
+            auto& instance = m_instances[i];
+
+            ImGui::PushID((int)i);
+
+            if (instance.ok) {
+                ImGui::Text("#%zu 0x%llX", i, (unsigned long long)instance.address);
+            } else {
+                ImGui::TextColored({1.0f, 0.0f, 0.0f, 1.0f}, "#%zu 0x%llX (unreadable)", i,
+                    (unsigned long long)instance.address);
+            }
+
+            ImGui::SameLine();
+            ImGui::SetNextItemWidth(120.0f);
+
+            if (ImGui::InputFloat("##label", &instance.label)) {
+                analyze();
+            }
+
+            ImGui::PopID();
+        }
+
+        ImGui::TreePop();
+    }
+
+    // Keep the number of table columns within what ImGui supports.
+    constexpr size_t max_instance_columns = 32;
+    auto num_instance_columns = std::min(m_instances.size(), max_instance_columns);
+    auto flags = ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_ScrollX | ImGuiTableFlags_ScrollY;
+
+    m_display_order.clear();
+
+    for (size_t i = 0; i < m_columns.size(); ++i) {
+        if (!m_only_differing || !m_columns[i].all_equal) {
+            m_display_order.emplace_back(i);
+        }
+    }
+
+    if (m_rank) {
+        std::stable_sort(m_display_order.begin(), m_display_order.end(), [this](auto a, auto b) {
+            auto& ca = m_columns[a];
+            auto& cb = m_columns[b];
+
+            if (std::abs(ca.correlation) != std::abs(cb.correlation)) {
+                return std::abs(ca.correlation) > std::abs(cb.correlation);
+            }
+
+            return ca.variance > cb.variance;
+        });
+    }
+
+    if (ImGui::BeginTable("CompareResults", 4 + (int)num_instance_columns, flags, ImGui::GetContentRegionAvail())) {
+        ImGui::TableSetupScrollFreeze(2, 1);
+        ImGui::TableSetupColumn("Offset");
+        ImGui::TableSetupColumn("Field");
+        ImGui::TableSetupColumn("Variance");
+        ImGui::TableSetupColumn("Correlation");
+
+        for (size_t i = 0; i < num_instance_columns; ++i) {
+            ImGui::TableSetupColumn(fmt::format("#{}", i).c_str());
+        }
+
+        ImGui::TableHeadersRow();
+
+        ImGuiListClipper clipper{};
+        clipper.Begin((int)m_display_order.size());
+
+        while (clipper.Step()) {
+            for (auto row = clipper.DisplayStart; row < clipper.DisplayEnd; ++row) {
+                auto& column = m_columns[m_display_order[row]];
+
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn();
+                ImGui::Text("0x%llX", (unsigned long long)column.offset);
+                ImGui::TableNextColumn();
+                ImGui::TextUnformatted(column.field_name.c_str());
+                ImGui::TableNextColumn();
+                ImGui::Text("%.4g", column.variance);
+                ImGui::TableNextColumn();
+                ImGui::Text("%+.3f", column.correlation);
+
+                const auto* first = &m_mem[column.offset];
+
+                for (size_t i = 0; i < num_instance_columns; ++i) {
+                    const auto* cur = &m_mem[i * m_size + column.offset];
+                    auto differs = memcmp(first, cur, m_width) != 0;
+                    std::string value{};
+
+                    if (m_as_float && m_width >= 4) {
+                        value = fmt::format("{:g}", value_at(i, column.offset));
+                    } else {
+                        for (auto b = m_width - 1; b >= 0; --b) {
+                            fmt::format_to(std::back_inserter(value), "{:02X}", (uint8_t)cur[b]);
+                        }
+                    }
+
+                    ImGui::TableNextColumn();
+
+                    if (!m_instances[i].ok) {
+                        ImGui::TextDisabled("??");
+                    } else if (differs) {
+                        ImGui::TextColored({1.0f, 0.8f, 0.2f, 1.0f}, "%s", value.c_str());
+                    } else {
+                        ImGui::TextColored({0.6f, 0.6f, 0.6f, 1.0f}, "%s", value.c_str());
+                    }
+                }
+            }
+        }
+
+        ImGui::EndTable();
+    }
+}
+
+void CompareUi::read_instances(Process& process) {
+    m_instances.clear();
+    m_size = m_struct->size();
+
+    if (m_source == Source::Addresses) {
+        std::istringstream lines{m_addresses_text};
+        std::string line{};
+
+        while (std::getline(lines, line)) {
+            std::istringstream fields{line};
+            std::string address_str{};
+            Instance instance{};
+
+            if (!(fields >> address_str)) {
+                continue;
+            }
+
+            try {
+                instance.address = std::stoull(address_str, nullptr, 0);
+            } catch (...) {
+                spdlog::warn("Skipping invalid address {}", address_str);
+                continue;
+            }
+
+            fields >> instance.label;
+            m_instances.emplace_back(instance);
+        }
+    } else {
+        uintptr_t base{};
+
+        try {
+            base = std::stoull(m_array_base, nullptr, 0);
+        } catch (...) {
+            spdlog::error("Invalid array base {}", m_array_base);
+            return;
+        }
+
+        for (auto i = 0; i < m_array_count; ++i) {
+            m_instances.emplace_back(Instance{.address = base + i * (uintptr_t)m_array_stride});
+        }
+    }
+
+    // Read every instance in one batch.
+    m_mem.assign(m_instances.size() * m_size, std::byte{});
+    std::vector<Process::ReadRequest> requests(m_instances.size());
+
+    for (size_t i = 0; i < m_instances.size(); ++i) {
+        requests[i].address = m_instances[i].address;
+        requests[i].buffer = &m_mem[i * m_size];
+        requests[i].size = m_size;
+    }
+
+    process.read_batch(requests);
+
+    for (size_t i = 0; i < m_instances.size(); ++i) {
+        m_instances[i].ok = requests[i].ok;
+    }
+}
+
+double CompareUi::value_at(size_t instance, uintptr_t offset) const {
+    const auto* mem = &m_mem[instance * m_size + offset];
+    double value{};
+
+    switch (m_width) {
+    case 1:
+        value = *(const uint8_t*)mem;
+        break;
+    case 2:
+        value = *(const uint16_t*)mem;
+        break;
+    case 4:
+        value = m_as_float ? (double)*(const float*)mem : (double)*(const uint32_t*)mem;
+        break;
+    case 8:
+        value = m_as_float ? *(const double*)mem : (double)*(const uint64_t*)mem;
+        break;
+    }
+
+    // NaNs and infinities would poison the statistics for the whole column.
+    return std::isfinite(value) ? value : 0.0;
+}
+
+void CompareUi::analyze() {
+    m_columns.clear();
+
+    if (m_struct == nullptr || m_size < (size_t)m_width) {
+        return;
+    }
+
+    std::vector<size_t> readable{};
+
+    for (size_t i = 0; i < m_instances.size(); ++i) {
+        if (m_instances[i].ok) {
+            readable.emplace_back(i);
+        }
+    }
+
+    if (readable.empty()) {
+        return;
+    }
+
+    auto n = readable.size();
+    auto num_columns = m_size / m_width;
+
+    // Transpose into offset major order so the statistics for each offset are contiguous loops over the instances
+    // (which the compiler can vectorize).
+    std::vector<double> values(num_columns * n);
+    std::vector<double> labels(n);
+
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t c = 0; c < num_columns; ++c) {
+            values[c * n + i] = value_at(readable[i], c * m_width);
+        }
+
+        labels[i] = m_instances[readable[i]].label;
+    }
+
+    auto label_mean = 0.0;
+
+    for (size_t i = 0; i < n; ++i) {
+        label_mean += labels[i];
+    }
+
+    label_mean /= n;
+
+    auto label_variance = 0.0;
+
+    for (size_t i = 0; i < n; ++i) {
+        labels[i] -= label_mean;
+        label_variance += labels[i] * labels[i];
+    }
+
+    label_variance /= n;
+
+    std::vector<std::pair<uintptr_t, sdkgenny::Variable*>> fields{};
+    collect_variables(m_struct, 0, fields);
+
+    m_columns.resize(num_columns);
+
+    for (size_t c = 0; c < num_columns; ++c) {
+        const auto* col = &values[c * n];
+        auto mean = 0.0;
+
+        for (size_t i = 0; i < n; ++i) {
+            mean += col[i];
+        }
+
+        mean /= n;
+
+        auto variance = 0.0;
+        auto covariance = 0.0;
+
+        for (size_t i = 0; i < n; ++i) {
+            auto delta = col[i] - mean;
+            variance += delta * delta;
+            covariance += delta * labels[i];
+        }
+
+        variance /= n;
+        covariance /= n;
+
+        auto& column = m_columns[c];
+
+        column.offset = c * m_width;
+        column.variance = variance;
+        column.correlation =
+            variance > 0.0 && label_variance > 0.0 ? covariance / std::sqrt(variance * label_variance) : 0.0;
+        column.all_equal = true;
+
+        for (size_t i = 1; i < n && column.all_equal; ++i) {
+            column.all_equal = memcmp(&m_mem[readable[0] * m_size + column.offset],
+                                   &m_mem[readable[i] * m_size + column.offset], m_width) == 0;
+        }
+
+        for (auto&& [field_offset, var] : fields) {
+            if (field_offset <= column.offset && column.offset < field_offset + var->size()) {
+                column.field_name = var->name();
+
+                if (field_offset != column.offset) {
+                    column.field_name += fmt::format("+0x{:X}", column.offset - field_offset);
+                }
+
+                break;
+            }
+        }
+    }
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <sdkgenny.hpp>
+
+#include "Process.hpp"
+
+// Compares several instances of the same struct side by side to find the fields that discriminate between them (such
+// as "is player" or "team"). Offsets are ranked by how well their values correlate with a label given per instance.
+class CompareUi {
+public:
+    void ui(Process& process, sdkgenny::Struct* struct_, uintptr_t address);
+
+private:
+    enum class Source {
+        Addresses,
+        ArrayRange
+    };
+
+    struct Instance {
+        uintptr_t address{};
+        float label{};
+        bool ok{};
+    };
+
+    struct Column {
+        uintptr_t offset{};
+        std::string field_name{};
+        bool all_equal{};
+        double variance{};
+        double correlation{};
+    };
+
+    Source m_source{Source::Addresses};
+    std::string m_addresses_text{};
+    std::string m_array_base{};
+    int m_array_stride{};
+    int m_array_count{8};
+    int m_width{4};
+    bool m_as_float{};
+    bool m_rank{true};
+    bool m_only_differing{true};
+
+    sdkgenny::Struct* m_struct{};
+    size_t m_size{};
+    std::vector<Instance> m_instances{};
+    // Instance major, m_size bytes per instance.
+    std::vector<std::byte> m_mem{};
+    std::vector<Column> m_columns{};
+    std::vector<size_t> m_display_order{};
+
+    void read_instances(Process& process);
+    void analyze();
+    double value_at(size_t instance, uintptr_t offset) const;
+};
@@ -10,6 +10,18 @@ void to_json(nlohmann::json& j, const Config& c) {
     j["display"]["print"] = c.display_print;
     j["refresh_rate"] = c.refresh_rate;
     j["always_on_top"] = c.always_on_top;
+    j["memory"]["budget"]["read_only_cache"] = c.budget_read_only_cache;
+    j["memory"]["budget"]["pointer_buffers"] = c.budget_pointer_buffers;
+    j["memory"]["budget"]["log"] = c.budget_log;
+    j["memory"]["warning_load"] = c.memory_warning_load;
+    j["memory"]["prefetch_budget"] = c.prefetch_budget;
+    j["read"]["limit_kib"] = c.read_limit_kib;
+    j["read"]["limit_reads"] = c.read_limit_reads;
+    j["read"]["scan_busy_threshold"] = c.scan_busy_threshold;
+    j["rpc"]["enabled"] = c.rpc_enabled;
+    j["rpc"]["port"] = c.rpc_port;
+    j["rpc"]["token"] = c.rpc_token;
+    j["snapshot"]["depth"] = c.snapshot_depth;
 }
 
 void from_json(const nlohmann::json& j, Config& c) {
@@ -31,4 +43,33 @@ void from_json(const nlohmann::json& j, Config& c) {
 
     c.refresh_rate = j.value("refresh_rate", 500);
     c.always_on_top = j.value("always_on_top", false);
+
+    if (j.find("memory") != j.end()) {
+        auto& memory = j.at("memory");
+
+        if (memory.find("budget") != memory.end()) {
+            c.budget_read_only_cache = memory.at("budget").value("read_only_cache", 0);
+            c.budget_pointer_buffers = memory.at("budget").value("pointer_buffers", 256);
+            c.budget_log = memory.at("budget").value("log", 64);
+        }
+
+        c.memory_warning_load = memory.value("warning_load", 90);
+        c.prefetch_budget = memory.value("prefetch_budget", 64);
+    }
+
+    if (j.find("read") != j.end()) {
+        c.read_limit_kib = j.at("read").value("limit_kib", 0);
+        c.read_limit_reads = j.at("read").value("limit_reads", 0);
+        c.scan_busy_threshold = j.at("read").value("scan_busy_threshold", 0);
+    }
+
+    if (j.find("rpc") != j.end()) {
+        c.rpc_enabled = j.at("rpc").value("enabled", false);
+        c.rpc_port = j.at("rpc").value("port", 27015);
+        c.rpc_token = j.at("rpc").value("token", "");
+    }
+
+    if (j.find("snapshot") != j.end()) {
+        c.snapshot_depth = j.at("snapshot").value("depth", 4);
+    }
 }
@@ -15,6 +15,30 @@ struct Config {
     bool display_print{true};
     int refresh_rate{500};
     bool always_on_top{false};
+
+    // Memory budgets in MiB per MemoryAccountant category (0 is unlimited).
+    int budget_read_only_cache{0};
+    int budget_pointer_buffers{256};
+    int budget_log{64};
+    // System memory load (percent) at which we start warning about swapping.
+    int memory_warning_load{90};
+    // KiB of speculative pointer prefetching done per frame (0 disables it).
+    int prefetch_budget{64};
+
+    // Read throttling (see ReadGovernor), 0 is unlimited. KiB and reads per second made to the process.
+    int read_limit_kib{0};
+    int read_limit_reads{0};
+    // Target CPU usage (percent) at which scans pause (0 never pauses).
+    int scan_busy_threshold{0};
+
+    // Local JSON-RPC control server (see RpcServer).
+    bool rpc_enabled{false};
+    int rpc_port{27015};
+    // Requests have to carry this, a new one is made every time the server starts.
+    std::string rpc_token{};
+
+    // How many pointers away from the root a snapshot bundle follows.
+    int snapshot_depth{4};
 };
 
 void to_json(nlohmann::json& j, const Config& c);
@@ -2,9 +2,16 @@
 
 #include <cstdint>
 #include <map>
+#include <optional>
 #include <string>
 
 class Helpers {
 public:
     virtual std::map<uint32_t, std::string> processes() = 0;
+
+    // Percentage of physical memory in use on the host machine.
+    virtual std::optional<uint32_t> memory_load() { return std::nullopt; }
+
+    // Bytes of physical memory used by ReGenny itself.
+    virtual std::optional<size_t> working_set() { return std::nullopt; }
 };
\ No newline at end of file
@@ -0,0 +1,462 @@
+#include <algorithm>
+#include <fstream>
+#include <unordered_set>
+
+#include <fmt/format.h>
+#include <imgui.h>
+#include <nfd.h>
+#include <spdlog/spdlog.h>
+
+#include "Utility.hpp"
+
+#include "LayoutUi.hpp"
+
+// sdkgenny doesn't track alignment so use the natural alignment of the type.
+static size_t alignment_of(sdkgenny::Type* type) {
+    if (auto array = dynamic_cast<sdkgenny::Array*>(type)) {
+        return alignment_of(array->of());
+    }
+
+    if (auto struct_ = dynamic_cast<sdkgenny::Struct*>(type)) {
+        size_t alignment{1};
+        std::vector<std::pair<uintptr_t, sdkgenny::Variable*>> variables{};
+
+        collect_variables(struct_, 0, variables);
+
+        for (auto&& [offset, var] : variables) {
+            alignment = std::max(alignment, alignment_of(var->type()));
+        }
+
+        return alignment;
+    }
+
+    size_t alignment{1};
+
+    while (alignment < 8 && type->size() % (alignment * 2) == 0) {
+        alignment *= 2;
+    }
+
+    return alignment;
+}
+
+static size_t line_of(uintptr_t offset) {
+    return offset / LayoutUi::cache_line_size;
+}
+
+static void finish_layout(LayoutUi::Layout& layout, size_t size, uint32_t min_changes) {
+    layout.size = size;
+    layout.num_lines = (size + LayoutUi::cache_line_size - 1) / LayoutUi::cache_line_size;
+
+    uintptr_t end{};
+    std::unordered_set<size_t> hot_lines{};
+
+    for (auto&& field : layout.fields) {
+        if (field.offset > end) {
+            layout.holes.emplace_back(LayoutUi::Hole{end, field.offset - end});
+        }
+
+        end = std::max<uintptr_t>(end, field.offset + field.size);
+
+        // Fields bigger than a cache line have to straddle so only count the ones that could have fit.
+        auto straddles = line_of(field.offset) != line_of(field.offset + field.size - 1);
+
+        if (straddles && field.size <= LayoutUi::cache_line_size) {
+            ++layout.num_straddlers;
+        }
+
+        if (min_changes != 0 && field.changes >= min_changes) {
+            for (auto line = line_of(field.offset); line <= line_of(field.offset + field.size - 1); ++line) {
+                hot_lines.emplace(line);
+            }
+        }
+    }
+
+    if (size > end) {
+        layout.holes.emplace_back(LayoutUi::Hole{end, size - end});
+    }
+
+    for (auto&& hole : layout.holes) {
+        layout.padding += hole.size;
+    }
+
+    layout.num_hot_lines = hot_lines.size();
+}
+
+LayoutUi::Analysis LayoutUi::analyze(sdkgenny::Struct* struct_, const std::vector<uint32_t>* change_counts) {
+    Analysis analysis{};
+    std::vector<std::pair<uintptr_t, sdkgenny::Variable*>> variables{};
+
+    collect_variables(struct_, 0, variables);
+    std::stable_sort(variables.begin(), variables.end(), [](auto&& a, auto&& b) { return a.first < b.first; });
+
+    auto& current = analysis.current;
+
+    for (auto&& [offset, var] : variables) {
+        // Bitfields share their storage so merge them into a single field.
+        if (!current.fields.empty() && current.fields.back().offset == offset) {
+            auto& field = current.fields.back();
+
+            field.size = std::max(field.size, var->size());
+            field.name += '/' + var->name();
+            continue;
+        }
+
+        Field field{};
+
+        field.offset = offset;
+        field.size = std::max<size_t>(var->size(), 1);
+        field.alignment = alignment_of(var->type());
+        field.name = var->name();
+        field.type_name = var->type()->name();
+
+        if (change_counts != nullptr) {
+            for (auto i = offset; i < offset + field.size && i < change_counts->size(); ++i) {
+                field.changes = std::max(field.changes, (*change_counts)[i]);
+            }
+        }
+
+        current.fields.emplace_back(std::move(field));
+    }
+
+    constexpr uint32_t min_changes = 1;
+    finish_layout(current, struct_->size(), change_counts != nullptr ? min_changes : 0);
+
+    // Fields inherited from parents can't be moved.
+    size_t fixed_size{};
+
+    for (auto&& parent : struct_->parents()) {
+        fixed_size += parent->size();
+    }
+
+    auto& suggested = analysis.suggested;
+    std::vector<Field> movable{};
+
+    for (auto&& field : current.fields) {
+        if (field.offset < fixed_size) {
+            suggested.fields.emplace_back(field);
+        } else {
+            movable.emplace_back(field);
+        }
+    }
+
+    // Hot fields first so they share as few cache lines as possible, then by decreasing alignment so there's no
+    // padding between fields.
+    std::stable_sort(movable.begin(), movable.end(), [](auto&& a, auto&& b) {
+        auto a_hot = a.changes != 0;
+        auto b_hot = b.changes != 0;
+
+        if (a_hot != b_hot) {
+            return a_hot;
+        }
+
+        if (a.alignment != b.alignment) {
+            return a.alignment > b.alignment;
+        }
+
+        return a.size > b.size;
+    });
+
+    uintptr_t offset = fixed_size;
+    size_t max_alignment{1};
+
+    for (auto&& field : movable) {
+        offset = (offset + field.alignment - 1) / field.alignment * field.alignment;
+        field.offset = offset;
+        offset += field.size;
+        max_alignment = std::max(max_alignment, field.alignment);
+        suggested.fields.emplace_back(std::move(field));
+    }
+
+    offset = (offset + max_alignment - 1) / max_alignment * max_alignment;
+    finish_layout(suggested, offset, change_counts != nullptr ? min_changes : 0);
+
+    return analysis;
+}
+
+std::string LayoutUi::report(sdkgenny::Struct* struct_, const Analysis& analysis) {
+    std::string out{};
+    auto it = std::back_inserter(out);
+
+    auto write_layout = [&](const char* title, const Layout& layout) {
+        fmt::format_to(it, "{}: size 0x{:X}, {} cache lines, {} bytes of holes, {} straddling fields", title,
+            layout.size, layout.num_lines, layout.padding, layout.num_straddlers);
+
+        if (layout.num_hot_lines != 0) {
+            fmt::format_to(it, ", hot fields on {} lines", layout.num_hot_lines);
+        }
+
+        out += '\n';
+
+        auto hole = layout.holes.begin();
+        size_t line = -1;
+
+        for (auto&& field : layout.fields) {
+            for (; hole != layout.holes.end() && hole->offset < field.offset; ++hole) {
+                fmt::format_to(it, "    0x{:04X} <hole 0x{:X}>\n", hole->offset, hole->size);
+            }
+
+            if (line_of(field.offset) != line) {
+                line = line_of(field.offset);
+                fmt::format_to(it, "  line {} (0x{:X})\n", line, line * cache_line_size);
+            }
+
+            fmt::format_to(
+                it, "    0x{:04X} {} {} (0x{:X} bytes)", field.offset, field.type_name, field.name, field.size);
+
+            if (line_of(field.offset) != line_of(field.offset + field.size - 1)) {
+                out += " [straddles]";
+            }
+
+            if (field.changes != 0) {
+                fmt::format_to(it, " [hot: {} changes]", field.changes);
+            }
+
+            out += '\n';
+        }
+
+        for (; hole != layout.holes.end(); ++hole) {
+            fmt::format_to(it, "    0x{:04X} <hole 0x{:X}>\n", hole->offset, hole->size);
+        }
+    };
+
+    fmt::format_to(it, "struct {}\n", struct_->name());
+    write_layout("Current", analysis.current);
+    write_layout("Suggested", analysis.suggested);
+
+    return out;
+}
+
+void LayoutUi::ui(sdkgenny::Sdk* sdk, sdkgenny::Struct* struct_, const std::vector<uint32_t>* change_counts) {
+    if (ImGui::BeginTabBar("LayoutTabs")) {
+        if (ImGui::BeginTabItem("Selected Type")) {
+            if (struct_ == nullptr) {
+                ImGui::Text("Error: No Type");
+            } else {
+                auto analysis = analyze(struct_, change_counts);
+
+                if (change_counts == nullptr || change_counts->empty()) {
+                    ImGui::TextDisabled("Attach and view the type in the memory view to find its hot fields.");
+                }
+
+                if (ImGui::Button("Copy Report")) {
+                    ImGui::SetClipboardText(report(struct_, analysis).c_str());
+                }
+
+                ImGui::SameLine();
+
+                if (ImGui::Button("Export Report")) {
+                    export_text(report(struct_, analysis));
+                }
+
+                ImGui::SameLine();
+                ImGui::Checkbox("Show suggested layout", &m_show_suggested);
+
+                auto& layout = m_show_suggested ? analysis.suggested : analysis.current;
+
+                ImGui::Text("Size 0x%zX (suggested 0x%zX), %zu cache lines, %zu bytes of holes, %zu straddling fields",
+                    layout.size, analysis.suggested.size, layout.num_lines, layout.padding, layout.num_straddlers);
+
+                if (layout.num_hot_lines != 0) {
+                    ImGui::Text("Hot fields touch %zu cache lines (%zu with the suggested layout)",
+                        analysis.current.num_hot_lines, analysis.suggested.num_hot_lines);
+                }
+
+                layout_table(layout);
+            }
+
+            ImGui::EndTabItem();
+        }
+
+        if (ImGui::BeginTabItem("Whole SDK")) {
+            if (ImGui::Button("Analyze SDK")) {
+                analyze_sdk(sdk);
+            }
+
+            ImGui::BeginDisabled(m_sdk_rows.empty());
+            ImGui::SameLine();
+
+            if (ImGui::Button("Copy Report")) {
+                ImGui::SetClipboardText(m_sdk_report.c_str());
+            }
+
+            ImGui::SameLine();
+
+            if (ImGui::Button("Export Report")) {
+                export_text(m_sdk_report);
+            }
+
+            ImGui::EndDisabled();
+
+            auto flags = ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_ScrollY;
+
+            if (ImGui::BeginTable("LayoutSdk", 5, flags, ImGui::GetContentRegionAvail())) {
+                ImGui::TableSetupScrollFreeze(0, 1);
+                ImGui::TableSetupColumn("Struct");
+                ImGui::TableSetupColumn("Size");
+                ImGui::TableSetupColumn("Holes");
+                ImGui::TableSetupColumn("Straddling");
+                ImGui::TableSetupColumn("Suggested Size");
+                ImGui::TableHeadersRow();
+
+                ImGuiListClipper clipper{};
+                clipper.Begin((int)m_sdk_rows.size());
+
+                while (clipper.Step()) {
+                    for (auto i = clipper.DisplayStart; i < clipper.DisplayEnd; ++i) {
+                        auto& row = m_sdk_rows[i];
+
+                        ImGui::TableNextRow();
+                        ImGui::TableNextColumn();
+                        ImGui::TextUnformatted(row.name.c_str());
+                        ImGui::TableNextColumn();
+                        ImGui::Text("0x%zX", row.size);
+                        ImGui::TableNextColumn();
+                        ImGui::Text("%zu", row.padding);
+                        ImGui::TableNextColumn();
+                        ImGui::Text("%zu", row.num_straddlers);
+                        ImGui::TableNextColumn();
+                        ImGui::Text("0x%zX", row.suggested_size);
+                    }
+                }
+
+                ImGui::EndTable();
+            }
+
+            ImGui::EndTabItem();
+        }
+
+        ImGui::EndTabBar();
+    }
+}
+
+void LayoutUi::layout_table(const Layout& layout) {
+    auto flags = ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_ScrollY;
+
+    if (!ImGui::BeginTable("LayoutFields", 5, flags, ImGui::GetContentRegionAvail())) {
+        return;
+    }
+
+    ImGui::TableSetupScrollFreeze(0, 1);
+    ImGui::TableSetupColumn("Line");
+    ImGui::TableSetupColumn("Offset");
+    ImGui::TableSetupColumn("Size");
+    ImGui::TableSetupColumn("Field");
+    ImGui::TableSetupColumn("Changes");
+    ImGui::TableHeadersRow();
+
+    auto hole = layout.holes.begin();
+
+    auto hole_row = [](const Hole& hole) {
+        ImGui::TableNextRow();
+        ImGui::TableNextColumn();
+        ImGui::Text("%zu", line_of(hole.offset));
+        ImGui::TableNextColumn();
+        ImGui::Text("0x%llX", (unsigned long long)hole.offset);
+        ImGui::TableNextColumn();
+        ImGui::Text("0x%zX", hole.size);
+        ImGui::TableNextColumn();
+        ImGui::TextDisabled("<hole>");
+        ImGui::TableNextColumn();
+    };
+
+    for (auto&& field : layout.fields) {
+        for (; hole != layout.holes.end() && hole->offset < field.offset; ++hole) {
+            hole_row(*hole);
+        }
+
+        auto straddles = line_of(field.offset) != line_of(field.offset + field.size - 1);
+
+        ImGui::TableNextRow();
+
+        // Alternate the background per cache line so the groups are easy to see.
+        if (line_of(field.offset) % 2 == 1) {
+            ImGui::TableSetBgColor(ImGuiTableBgTarget_RowBg1, ImGui::GetColorU32({0.3f, 0.3f, 0.4f, 0.35f}));
+        }
+
+        ImGui::TableNextColumn();
+
+        if (straddles) {
+            ImGui::TextColored({1.0f, 0.4f, 0.4f, 1.0f}, "%zu-%zu", line_of(field.offset),
+                line_of(field.offset + field.size - 1));
+        } else {
+            ImGui::Text("%zu", line_of(field.offset));
+        }
+
+        ImGui::TableNextColumn();
+        ImGui::Text("0x%llX", (unsigned long long)field.offset);
+        ImGui::TableNextColumn();
+        ImGui::Text("0x%zX", field.size);
+        ImGui::TableNextColumn();
+        ImGui::Text("%s %s", field.type_name.c_str(), field.name.c_str());
+        ImGui::TableNextColumn();
+
+        if (field.changes != 0) {
+            ImGui::TextColored({1.0f, 0.8f, 0.2f, 1.0f}, "%u", field.changes);
+        }
+    }
+
+    for (; hole != layout.holes.end(); ++hole) {
+        hole_row(*hole);
+    }
+
+    ImGui::EndTable();
+}
+
+void LayoutUi::analyze_sdk(sdkgenny::Sdk* sdk) {
+    m_sdk_rows.clear();
+    m_sdk_report.clear();
+
+    if (sdk == nullptr) {
+        return;
+    }
+
+    std::unordered_set<sdkgenny::Struct*> structs{};
+    sdk->global_ns()->get_all_in_children<sdkgenny::Struct>(structs);
+
+    std::vector<sdkgenny::Struct*> sorted{structs.begin(), structs.end()};
+    std::sort(sorted.begin(), sorted.end(), [](auto&& a, auto&& b) { return a->name() < b->name(); });
+
+    size_t total_padding{};
+    size_t total_savings{};
+
+    for (auto&& struct_ : sorted) {
+        if (struct_->size() == 0) {
+            continue;
+        }
+
+        auto analysis = analyze(struct_, nullptr);
+
+        m_sdk_rows.emplace_back(SdkRow{
+            .name = struct_->name(),
+            .size = analysis.current.size,
+            .padding = analysis.current.padding,
+            .num_straddlers = analysis.current.num_straddlers,
+            .suggested_size = analysis.suggested.size,
+        });
+
+        total_padding += analysis.current.padding;
+        total_savings += analysis.current.size - std::min(analysis.current.size, analysis.suggested.size);
+        m_sdk_report += report(struct_, analysis);
+        m_sdk_report += '\n';
+    }
+
+    // Worst offenders first.
+    std::stable_sort(
+        m_sdk_rows.begin(), m_sdk_rows.end(), [](auto&& a, auto&& b) { return a.padding > b.padding; });
+
+    m_sdk_report.insert(0, fmt::format("{} structs, {} bytes of holes, {} bytes saved by the suggested layouts\n\n",
+                               m_sdk_rows.size(), total_padding, total_savings));
+}
+
+void LayoutUi::export_text(const std::string& text) {
+    nfdchar_t* out_path{};
+
+    if (NFD_SaveDialog("txt", nullptr, &out_path) != NFD_OKAY) {
+        return;
+    }
+
+    std::ofstream f{out_path};
+    f << text;
+    spdlog::info("Exported layout report to {}", out_path);
+    free(out_path);
+}
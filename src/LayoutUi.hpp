@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <sdkgenny.hpp>
+
+// Shows how a struct's fields fall into cache lines: padding holes, fields straddling a line boundary and how the hot
+// fields (the ones seen changing in the memory view) are spread out. Suggests a reordering that packs the hot fields
+// together and removes padding, and can report on every struct in the SDK at once.
+class LayoutUi {
+public:
+    static constexpr size_t cache_line_size = 64;
+
+    struct Field {
+        uintptr_t offset{};
+        size_t size{};
+        size_t alignment{};
+        std::string name{};
+        std::string type_name{};
+        uint32_t changes{};
+    };
+
+    struct Hole {
+        uintptr_t offset{};
+        size_t size{};
+    };
+
+    struct Layout {
+        std::vector<Field> fields{};
+        std::vector<Hole> holes{};
+        size_t size{};
+        size_t padding{};
+        size_t num_straddlers{};
+        size_t num_lines{};
+        // Number of distinct cache lines the hot fields touch.
+        size_t num_hot_lines{};
+    };
+
+    struct Analysis {
+        Layout current{};
+        Layout suggested{};
+    };
+
+    void ui(sdkgenny::Sdk* sdk, sdkgenny::Struct* struct_, const std::vector<uint32_t>* change_counts);
+
+    // change_counts is indexed by byte offset into struct_ and may be null if there's no live data.
+    static Analysis analyze(sdkgenny::Struct* struct_, const std::vector<uint32_t>* change_counts);
+    static std::string report(sdkgenny::Struct* struct_, const Analysis& analysis);
+
+private:
+    struct SdkRow {
+        std::string name{};
+        size_t size{};
+        size_t padding{};
+        size_t num_straddlers{};
+        size_t suggested_size{};
+    };
+
+    bool m_show_suggested{};
+    std::vector<SdkRow> m_sdk_rows{};
+    std::string m_sdk_report{};
+
+    void layout_table(const Layout& layout);
+    void analyze_sdk(sdkgenny::Sdk* sdk);
+    static void export_text(const std::string& text);
+};
@@ -1,5 +1,13 @@
 #include "LoggerUi.hpp"
 
+LoggerUi::LoggerUi() {
+    MemoryAccountant::get().add_evictable(MemoryAccountant::Category::Log, this);
+}
+
+LoggerUi::~LoggerUi() {
+    MemoryAccountant::get().remove_evictable(MemoryAccountant::Category::Log, this);
+}
+
 void LoggerUi::ui() {
     ImGui::BeginChild("logger");
     ImGui::TextUnformatted(m_buf.begin());
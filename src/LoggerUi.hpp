@@ -1,19 +1,46 @@
 #pragma once
 
+#include <algorithm>
+#include <string>
+
 #include <fmt/format.h>
 #include <imgui.h>
 #include <spdlog/sinks/base_sink.h>
 #include <spdlog/spdlog.h>
 
+#include "MemoryAccountant.hpp"
+
 template <typename Mutex> class LoggerUiSink : public spdlog::sinks::base_sink<Mutex> {
 public:
     LoggerUiSink(ImGuiTextBuffer& buf, bool& scroll_to_bottom) : m_buf{buf}, m_scroll_to_bottom{scroll_to_bottom} {}
 
+    // Removes at least bytes_wanted bytes (rounded up to a whole line) from the start of the log. Returns the number of
+    // bytes freed.
+    size_t trim(size_t bytes_wanted) {
+        std::lock_guard _{spdlog::sinks::base_sink<Mutex>::mutex_};
+
+        auto old_capacity = (size_t)m_buf.Buf.Capacity;
+        auto cut = std::find(m_buf.begin() + std::min<size_t>(bytes_wanted, m_buf.size()), m_buf.end(), '\n');
+
+        if (cut != m_buf.end()) {
+            ++cut;
+        }
+
+        std::string rest{cut, m_buf.end()};
+
+        m_buf.clear();
+        m_buf.append(rest.c_str());
+        m_usage.set(m_buf.Buf.Capacity);
+
+        return old_capacity - std::min(old_capacity, (size_t)m_buf.Buf.Capacity);
+    }
+
 protected:
     void sink_it_(const spdlog::details::log_msg& msg) override {
         spdlog::memory_buf_t formatted{};
         spdlog::sinks::base_sink<Mutex>::formatter_->format(msg, formatted);
         m_buf.append(fmt::to_string(formatted).c_str());
+        m_usage.set(m_buf.Buf.Capacity);
         m_scroll_to_bottom = true;
     }
 
@@ -22,10 +49,14 @@ protected:
 private:
     ImGuiTextBuffer& m_buf{};
     bool& m_scroll_to_bottom{};
+    MemoryAccountant::Usage m_usage{MemoryAccountant::Category::Log};
 };
 
-class LoggerUi {
+class LoggerUi : public MemoryAccountant::Evictable {
 public:
+    LoggerUi();
+    ~LoggerUi() override;
+
     void ui();
 
     auto&& logger() const { return m_logger; }
@@ -33,10 +64,14 @@ public:
 
     void clear() { m_buf.clear(); }
 
+    // MemoryAccountant::Evictable
+    std::chrono::steady_clock::time_point last_used() const override { return {}; }
+    size_t evict(size_t bytes_wanted) override { return m_sink->trim(bytes_wanted); }
+
 private:
     ImGuiTextBuffer m_buf{};
     bool m_scroll_to_bottom{};
     std::shared_ptr<LoggerUiSink<std::mutex>> m_sink{
         std::make_shared<LoggerUiSink<std::mutex>>(m_buf, m_scroll_to_bottom)};
     std::shared_ptr<spdlog::logger> m_logger{std::make_shared<spdlog::logger>("LoggerUi", m_sink)};
-};
\ No newline at end of file
+};
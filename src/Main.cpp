@@ -1,5 +1,6 @@
 #include <cstdio>
 #include <filesystem>
+#include <optional>
 
 #include <SDL3/SDL.h>
 #include <glad/glad.h> // Initialize with gladLoadGL()
@@ -10,6 +11,7 @@
 #include "scope_guard.hpp"
 
 #include "ReGenny.hpp"
+#include "Trace.hpp"
 
 // Main code
 int main(int, char**) {
@@ -89,8 +91,11 @@ int main(int, char**) {
     // Main loop
     bool done = false;
 
+    Trace::set_thread_name("main");
+
     while (!done) {
         auto start_time = SDL_GetPerformanceCounter();
+        auto frame_scope = std::make_optional<Trace::Scope>("frame", "frame");
 
         // Poll and handle events (inputs, window resize, etc.)
         // You can read the io.WantCaptureMouse, io.WantCaptureKeyboard flags to tell if dear imgui wants to use your
@@ -100,6 +105,7 @@ int main(int, char**) {
         // Generally you may always pass all inputs to dear imgui, and hide them from your application based on those
         // two flags.
         SDL_Event e{};
+        auto events_scope = std::make_optional<Trace::Scope>("events", "frame");
 
         while (SDL_PollEvent(&e)) {
             ImGui_ImplSDL3_ProcessEvent(&e);
@@ -113,17 +119,26 @@ int main(int, char**) {
             }
         }
 
-        regenny.update();
+        events_scope.reset();
+
+        {
+            TRACE_SCOPE("update", "frame");
+            regenny.update();
+        }
 
         // Start the Dear ImGui frame
         ImGui_ImplOpenGL3_NewFrame();
         ImGui_ImplSDL3_NewFrame();
         ImGui::NewFrame();
 
-        regenny.ui();
-        // ImGui::ShowDemoWindow();
+        {
+            TRACE_SCOPE("ui", "frame");
+            regenny.ui();
+            // ImGui::ShowDemoWindow();
+        }
 
         // Rendering
+        auto render_scope = std::make_optional<Trace::Scope>("render", "frame");
         ImGui::Render();
         glViewport(0, 0, (int)io.DisplaySize.x, (int)io.DisplaySize.y);
         glClearColor(
@@ -131,6 +146,8 @@ int main(int, char**) {
         glClear(GL_COLOR_BUFFER_BIT);
         ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
         SDL_GL_SwapWindow(window);
+        render_scope.reset();
+        frame_scope.reset();
 
         auto end_time = SDL_GetPerformanceCounter();
         auto elapsed_ms = (end_time - start_time) / (float)SDL_GetPerformanceFrequency() * 1000.0f;
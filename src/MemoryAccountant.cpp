@@ -0,0 +1,101 @@
+#include <algorithm>
+#include <vector>
+
+#include "MemoryAccountant.hpp"
+
+using namespace std::literals;
+
+MemoryAccountant::Usage& MemoryAccountant::Usage::operator=(Usage&& other) noexcept {
+    if (this != &other) {
+        set(0);
+        m_category = other.m_category;
+        m_bytes = other.m_bytes;
+        other.m_bytes = 0;
+    }
+
+    return *this;
+}
+
+void MemoryAccountant::Usage::set(size_t bytes) {
+    if (bytes == m_bytes) {
+        return;
+    }
+
+    MemoryAccountant::get().add(m_category, (int64_t)bytes - (int64_t)m_bytes);
+    m_bytes = bytes;
+}
+
+MemoryAccountant& MemoryAccountant::get() {
+    // Intentionally leaked so owners with static storage duration can still unregister during shutdown.
+    static auto accountant = new MemoryAccountant{};
+    return *accountant;
+}
+
+std::string_view MemoryAccountant::category_name(Category category) {
+    switch (category) {
+    case Category::ReadOnlyCache:
+        return "Read-only cache";
+    case Category::PointerBuffers:
+        return "Pointer buffers";
+    case Category::Props:
+        return "Props";
+    case Category::Snapshots:
+        return "Snapshots";
+    case Category::Log:
+        return "Log";
+    default:
+        return "Unknown";
+    }
+}
+
+size_t MemoryAccountant::total_bytes() const {
+    size_t total{};
+
+    for (auto&& bytes : m_bytes) {
+        total += bytes.load();
+    }
+
+    return total;
+}
+
+void MemoryAccountant::add_evictable(Category category, Evictable* evictable) {
+    std::scoped_lock _{m_evictables_lock};
+    m_evictables[static_cast<size_t>(category)].emplace(evictable);
+}
+
+void MemoryAccountant::remove_evictable(Category category, Evictable* evictable) {
+    std::scoped_lock _{m_evictables_lock};
+    m_evictables[static_cast<size_t>(category)].erase(evictable);
+}
+
+size_t MemoryAccountant::enforce_budgets(const std::array<size_t, num_categories>& budgets) {
+    std::scoped_lock _{m_evictables_lock};
+    size_t total_freed{};
+
+    for (size_t i = 0; i < num_categories; ++i) {
+        auto budget = budgets[i];
+        auto used = (size_t)std::max<int64_t>(m_bytes[i].load(), 0);
+
+        if (budget == 0 || used <= budget) {
+            continue;
+        }
+
+        // Evict the least recently used owners first.
+        std::vector<Evictable*> candidates{m_evictables[i].begin(), m_evictables[i].end()};
+        std::sort(candidates.begin(), candidates.end(),
+            [](auto&& a, auto&& b) { return a->last_used() < b->last_used(); });
+
+        for (auto&& candidate : candidates) {
+            auto freed = candidate->evict(used - budget);
+
+            total_freed += freed;
+            used -= std::min(used, freed);
+
+            if (used <= budget) {
+                break;
+            }
+        }
+    }
+
+    return total_freed;
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string_view>
+#include <unordered_set>
+
+// Keeps per category byte counters for every cache and buffer ReGenny owns so we can see where memory goes during long
+// sessions, and evicts from those caches when a category goes over its budget.
+class MemoryAccountant {
+public:
+    enum class Category {
+        ReadOnlyCache,
+        PointerBuffers,
+        Props,
+        Snapshots,
+        Log,
+        Count
+    };
+
+    static constexpr auto num_categories = static_cast<size_t>(Category::Count);
+
+    // Tracks the bytes owned by a single buffer. Owners hold one of these and call set() whenever their buffer changes
+    // size. The bytes are released from the category when the usage is destroyed.
+    class Usage {
+    public:
+        Usage(Category category) : m_category{category} {}
+        Usage(const Usage&) = delete;
+        Usage(Usage&& other) noexcept : m_category{other.m_category}, m_bytes{other.m_bytes} { other.m_bytes = 0; }
+        Usage& operator=(const Usage&) = delete;
+        Usage& operator=(Usage&& other) noexcept;
+        ~Usage() { set(0); }
+
+        void set(size_t bytes);
+        auto bytes() const { return m_bytes; }
+
+    private:
+        Category m_category{};
+        size_t m_bytes{};
+    };
+
+    // Owners of caches that can give memory back when their category is over budget.
+    class Evictable {
+    public:
+        virtual ~Evictable() = default;
+
+        // Used to evict the least recently used owners first.
+        virtual std::chrono::steady_clock::time_point last_used() const = 0;
+
+        // Frees up to bytes_wanted bytes of memory that isn't currently being displayed. Returns the number of bytes
+        // actually freed.
+        virtual size_t evict(size_t bytes_wanted) = 0;
+    };
+
+    static MemoryAccountant& get();
+    static std::string_view category_name(Category category);
+
+    size_t bytes(Category category) const { return m_bytes[static_cast<size_t>(category)].load(); }
+    size_t total_bytes() const;
+
+    void add_evictable(Category category, Evictable* evictable);
+    void remove_evictable(Category category, Evictable* evictable);
+
+    // Evicts from every category whose usage is over its budget. A budget of 0 means unlimited. Returns the number of
+    // bytes freed.
+    size_t enforce_budgets(const std::array<size_t, num_categories>& budgets);
+
+private:
+    std::array<std::atomic<int64_t>, num_categories> m_bytes{};
+
+    std::mutex m_evictables_lock{};
+    std::array<std::unordered_set<Evictable*>, num_categories> m_evictables{};
+
+    MemoryAccountant() = default;
+
+    void add(Category category, int64_t delta) { m_bytes[static_cast<size_t>(category)] += delta; }
+};
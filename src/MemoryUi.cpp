@@ -1,10 +1,13 @@
+#include <algorithm>
 #include <array>
+#include <cctype>
+#include <cstring>
+#include <functional>
 
 #include <fmt/format.h>
 #include <imgui.h>
 #include <imgui_internal.h>
-
-#include "node/Pointer.hpp"
+#include <imgui_stdlib.h>
 
 #include "MemoryUi.hpp"
 
@@ -21,6 +24,7 @@ MemoryUi::MemoryUi(
     auto root = std::make_unique<node::Pointer>(m_cfg, m_process, m_proxy_variable.get(), m_props);
     root->is_collapsed(false);
 
+    m_root_ptr = root.get();
     m_root = std::move(root);
 }
 
@@ -30,7 +34,7 @@ void MemoryUi::display(uintptr_t address) {
     auto needs_space = false;
 
     if (m_cfg.display_address) {
-        if constexpr (sizeof(void*) == 8) {
+        if (m_process.pointer_size() == 8) {
             fmt::format_to(std::back_inserter(m_header), "{:16}", "Address");
         } else {
             fmt::format_to(std::back_inserter(m_header), "{:8}", "Address");
@@ -69,8 +73,218 @@ void MemoryUi::display(uintptr_t address) {
     ImGui::TextColored({0.6f, 0.6f, 0.6f, 1.0f}, "%s", m_header.c_str());
 
     if (m_root != nullptr) {
+        display_filter();
+
         ImGui::BeginChild("MemoryUiRoot", ImGui::GetContentRegionAvail());
+        node::Base::filter = m_filter_text.empty() ? nullptr : &m_filter;
         m_root->display(address, 0, (std::byte*)&address);
+        node::Base::filter = nullptr;
+        m_filter.scroll_to_current = false;
         ImGui::EndChild();
+
+        track_changes();
+    }
+}
+
+void MemoryUi::track_changes() {
+    auto& mem = m_root_ptr->mem();
+
+    if (m_root_ptr->address() != m_tracked_address || mem.size() != m_tracked_mem.size()) {
+        m_tracked_address = m_root_ptr->address();
+        m_tracked_mem = mem;
+        m_change_counts.assign(mem.size(), 0);
+        return;
+    }
+
+    // The buffer is only refreshed every refresh_rate ms so most frames there's nothing to do.
+    if (memcmp(mem.data(), m_tracked_mem.data(), mem.size()) == 0) {
+        return;
+    }
+
+    for (size_t i = 0; i < mem.size(); ++i) {
+        if (mem[i] != m_tracked_mem[i]) {
+            ++m_change_counts[i];
+        }
+    }
+
+    m_tracked_mem = mem;
+}
+
+void MemoryUi::display_filter() {
+    ImGui::SetNextItemWidth(300.0f);
+
+    auto enter = ImGui::InputTextWithHint(
+        "##filter", "Filter (name, type or value)", &m_filter_text, ImGuiInputTextFlags_EnterReturnsTrue);
+    auto now = std::chrono::steady_clock::now();
+
+    if (m_filter_text != m_filtered_text || now >= m_filter_time) {
+        update_filter();
+    }
+
+    if (m_filter_text.empty()) {
+        return;
+    }
+
+    ImGui::SameLine();
+
+    if (ImGui::ArrowButton("##prev", ImGuiDir_Up)) {
+        jump_to_match(-1);
+    }
+
+    ImGui::SameLine();
+
+    if (ImGui::ArrowButton("##next", ImGuiDir_Down) || enter) {
+        jump_to_match(1);
+    }
+
+    ImGui::SameLine();
+    ImGui::Checkbox("Matches only", &m_filter.only_matches);
+
+    if (ImGui::IsItemHovered()) {
+        ImGui::SetTooltip("Hide everything that isn't a match or above one");
+    }
+
+    ImGui::SameLine();
+
+    if (m_matches.empty()) {
+        ImGui::TextColored({0.6f, 0.6f, 0.6f, 1.0f}, "No matches");
+    } else if (m_filter.current == nullptr) {
+        ImGui::TextColored({0.6f, 0.6f, 0.6f, 1.0f}, "%zu matches", m_matches.size());
+    } else {
+        ImGui::TextColored({0.6f, 0.6f, 0.6f, 1.0f}, "%zu/%zu", m_match_index + 1, m_matches.size());
+    }
+}
+
+void MemoryUi::update_filter() {
+    auto current = m_filter.current;
+
+    m_filter_time = std::chrono::steady_clock::now() + std::chrono::milliseconds(m_cfg.refresh_rate);
+
+    if (m_filter_text.empty()) {
+        m_filtered_text.clear();
+        m_filter.matches.clear();
+        m_filter.ancestors.clear();
+        m_filter.current = nullptr;
+        m_filter_nodes.clear();
+        m_matches.clear();
+        m_parents.clear();
+        return;
+    }
+
+    auto contains = [&](std::string_view s) {
+        auto it = std::search(s.begin(), s.end(), m_filter_text.begin(), m_filter_text.end(), [](char a, char b) {
+            return std::tolower((unsigned char)a) == std::tolower((unsigned char)b);
+        });
+        return it != s.end();
+    };
+
+    std::vector<std::string_view> strs{};
+
+    // Returns whether the node's match changed.
+    auto match = [&](FilterNode& n, bool force) {
+        strs.clear();
+        n.node->filter_text(strs);
+
+        size_t hash{};
+
+        for (auto&& str : strs) {
+            hash = hash * 31 + std::hash<std::string_view>{}(str);
+        }
+
+        if (!force && hash == n.hash) {
+            return false;
+        }
+
+        auto matches = std::any_of(strs.begin(), strs.end(), contains);
+        auto changed = force || matches != n.matches;
+
+        n.hash = hash;
+        n.matches = matches;
+        return changed;
+    };
+
+    auto changed = false;
+
+    if (m_filter_text != m_filtered_text || m_filter_structure != node::Base::structure_version) {
+        m_filtered_text = m_filter_text;
+        m_filter_structure = node::Base::structure_version;
+        m_filter_nodes.clear();
+        m_parents.clear();
+
+        std::function<void(node::Base&)> visit = [&](node::Base& node) {
+            m_filter_nodes.emplace_back(&node);
+            node.for_each_child([&](node::Base& child) {
+                m_parents[&child] = &node;
+                visit(child);
+            });
+        };
+
+        // The root pointer itself has no row.
+        m_root->for_each_child([&](node::Base& child) {
+            m_parents[&child] = m_root.get();
+            visit(child);
+        });
+
+        for (auto&& n : m_filter_nodes) {
+            match(n, true);
+        }
+
+        changed = true;
+    } else {
+        for (auto&& n : m_filter_nodes) {
+            changed |= match(n, false);
+        }
+    }
+
+    if (!changed) {
+        return;
+    }
+
+    m_filter.matches.clear();
+    m_filter.ancestors.clear();
+    m_filter.current = nullptr;
+    m_matches.clear();
+
+    for (auto&& n : m_filter_nodes) {
+        if (!n.matches) {
+            continue;
+        }
+
+        m_filter.matches.emplace(n.node);
+        m_matches.emplace_back(n.node);
+
+        for (auto it = m_parents.find(n.node); it != m_parents.end(); it = m_parents.find(it->second)) {
+            if (!m_filter.ancestors.emplace(it->second).second) {
+                break;
+            }
+        }
+    }
+
+    // Stay on the same match while it's still there.
+    if (auto it = std::find(m_matches.begin(), m_matches.end(), current); it != m_matches.end()) {
+        m_filter.current = current;
+        m_match_index = it - m_matches.begin();
+    }
+}
+
+void MemoryUi::jump_to_match(int direction) {
+    // The tree may have changed since the last time the filter ran, refresh it so m_parents can be followed safely.
+    update_filter();
+
+    if (m_matches.empty()) {
+        return;
+    }
+
+    if (m_filter.current == nullptr) {
+        m_match_index = direction > 0 ? 0 : m_matches.size() - 1;
+    } else {
+        m_match_index = (m_match_index + m_matches.size() + direction) % m_matches.size();
+    }
+
+    m_filter.current = m_matches[m_match_index];
+    m_filter.scroll_to_current = true;
+
+    for (auto it = m_parents.find(m_matches[m_match_index]); it != m_parents.end(); it = m_parents.find(it->second)) {
+        it->second->expand();
     }
 }
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <chrono>
 #include <map>
 #include <memory>
 #include <unordered_map>
@@ -10,6 +11,7 @@
 #include "Config.hpp"
 #include "Process.hpp"
 #include "node/Base.hpp"
+#include "node/Pointer.hpp"
 #include "node/Property.hpp"
 
 class MemoryUi {
@@ -21,6 +23,9 @@ public:
 
     auto&& props() { return m_props; }
 
+    // Number of times each byte of the root struct has been seen changing since the address was last changed.
+    auto&& change_counts() const { return m_change_counts; }
+
 private:
     Config& m_cfg;
     sdkgenny::Sdk& m_sdk;
@@ -29,8 +34,41 @@ private:
 
     std::unique_ptr<sdkgenny::Variable> m_proxy_variable{};
     std::unique_ptr<node::Base> m_root{};
+    node::Pointer* m_root_ptr{};
 
     node::Property m_props;
 
     std::string m_header{};
+
+    uintptr_t m_tracked_address{};
+    std::vector<std::byte> m_tracked_mem{};
+    std::vector<uint32_t> m_change_counts{};
+
+    // Incremental search over the nodes that have been built. Matching only looks at the strings the nodes last
+    // formatted so it never reads memory. The tree is only walked again when the text or the tree changes, otherwise
+    // every refresh_rate ms only the nodes whose strings changed are matched again.
+    std::string m_filter_text{};
+    std::string m_filtered_text{};
+    node::Base::Filter m_filter{};
+
+    struct FilterNode {
+        node::Base* node{};
+        // Of its strings when it was last matched.
+        size_t hash{};
+        bool matches{};
+    };
+
+    // Every node in display order as of the last walk, and the structure_version it was walked at.
+    std::vector<FilterNode> m_filter_nodes{};
+    uint64_t m_filter_structure{};
+    // In display order, with the parent of each node so jumping to a match can open the nodes above it.
+    std::vector<node::Base*> m_matches{};
+    std::unordered_map<node::Base*, node::Base*> m_parents{};
+    size_t m_match_index{};
+    std::chrono::steady_clock::time_point m_filter_time{};
+
+    void track_changes();
+    void display_filter();
+    void update_filter();
+    void jump_to_match(int direction);
 };
\ No newline at end of file
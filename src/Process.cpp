@@ -1,23 +1,359 @@
+#include <algorithm>
+#include <cstring>
+
+#include "Trace.hpp"
+
 #include "Process.hpp"
 
+using namespace std::literals;
+
+namespace {
+// How long a page that failed to read is assumed to stay unreadable.
+constexpr auto bad_page_lifetime = 2s;
+
+uintptr_t page_of(uintptr_t address) {
+    return address & ~(Process::page_size - 1);
+}
+} // namespace
+
+Process::Process() {
+    MemoryAccountant::get().add_evictable(MemoryAccountant::Category::ReadOnlyCache, this);
+}
+
+Process::~Process() {
+    MemoryAccountant::get().remove_evictable(MemoryAccountant::Category::ReadOnlyCache, this);
+}
+
 bool Process::read(uintptr_t address, void* buffer, size_t size) {
-    // If we're reading from read-only memory we can just use the cached version since it hasn't changed.
-    for (auto&& ro_allocation : m_read_only_allocations) {
-        if (ro_allocation.start <= address && address + size <= ro_allocation.end &&
-            ro_allocation.mem.size() == ro_allocation.size) {
-            auto offset = address - ro_allocation.start;
+    return read_checked(address, buffer, size) == ReadResult::Ok;
+}
+
+Process::ReadResult Process::read_checked(uintptr_t address, void* buffer, size_t size) {
+    {
+        std::shared_lock _{m_read_only_lock};
+
+        // If we're reading from read-only memory we can just use the cached version since it hasn't changed.
+        for (auto&& ro_allocation : m_read_only_allocations) {
+            auto data = ro_allocation.data();
+
+            if (ro_allocation.start <= address && address + size <= ro_allocation.end && data != nullptr) {
+                auto offset = address - ro_allocation.start;
+
+                // two incase the size causes overflow
+                if (offset >= ro_allocation.size || offset + size >= ro_allocation.size) {
+                    return ReadResult::Unreadable;
+                }
+
+                memcpy(buffer, data + offset, size);
+                ro_allocation.last_read->store(
+                    std::chrono::steady_clock::now().time_since_epoch().count(), std::memory_order_relaxed);
+                return ReadResult::Ok;
+            }
+        }
+    }
+
+    if (!is_readable(address, size)) {
+        return ReadResult::Unreadable;
+    }
+
+    // Canceled while being throttled, not a bad page.
+    if (!m_governor.acquire(size)) {
+        return ReadResult::Canceled;
+    }
+
+    if (handle_read(address, buffer, size)) {
+        return ReadResult::Ok;
+    }
+
+    // A failed read within a single page tells us that page is unreadable.
+    if (size > 0 && page_of(address) == page_of(address + size - 1)) {
+        mark_bad_page(page_of(address));
+    }
+
+    return ReadResult::Unreadable;
+}
+
+Process::PageMask Process::read_partial(uintptr_t address, void* buffer, size_t size) {
+    Trace::Scope trace{"read_partial", "memory"};
+    PageMask mask{page_of(address)};
+
+    trace.arg("bytes", (int64_t)size);
+
+    if (size == 0) {
+        return mask;
+    }
+
+    auto num_pages = (page_of(address + size - 1) - mask.first_page) / page_size + 1;
+    auto out = (std::byte*)buffer;
+
+    mask.valid.assign(num_pages, true);
+
+    // Portion of the read that falls in page i.
+    auto chunk = [&](size_t i) {
+        auto start = std::max(address, mask.first_page + i * page_size);
+        auto end = std::min(address + size, mask.first_page + (i + 1) * page_size);
+        return std::make_pair(start, end);
+    };
+
+    for (size_t i = 0; i < num_pages; ++i) {
+        auto [start, end] = chunk(i);
+        mask.valid[i] = is_readable(start, end - start);
+    }
+
+    // Zeroes a page and leaves it out of the mask. Only pages that failed to read get remembered as bad, a canceled
+    // read says nothing about the page.
+    auto skip = [&](size_t i) {
+        auto [start, end] = chunk(i);
+        mask.valid[i] = false;
+        memset(out + (start - address), 0, end - start);
+    };
+
+    // Read each run of pages not known to be bad in one go, and only go page by page if the run fails.
+    for (size_t first = 0; first < num_pages;) {
+        if (!mask.valid[first] || mask.canceled) {
+            skip(first);
+            ++first;
+            continue;
+        }
+
+        auto last = first;
+
+        while (last + 1 < num_pages && mask.valid[last + 1]) {
+            ++last;
+        }
+
+        auto run_start = chunk(first).first;
+        auto run_end = chunk(last).second;
+        auto run = read_checked(run_start, out + (run_start - address), run_end - run_start);
+
+        for (auto i = first; i <= last && run != ReadResult::Ok; ++i) {
+            auto [start, end] = chunk(i);
+            auto result = mask.canceled ? ReadResult::Canceled : run;
+
+            // A lone page already failed on its own, the pages of a longer run get another go one by one.
+            if (result == ReadResult::Unreadable && first != last) {
+                result = read_checked(start, out + (start - address), end - start);
+            }
+
+            if (result == ReadResult::Ok) {
+                continue;
+            }
+
+            if (result == ReadResult::Canceled) {
+                mask.canceled = true;
+            } else {
+                mark_bad_page(mask.first_page + i * page_size);
+            }
+
+            skip(i);
+        }
+
+        first = last + 1;
+    }
+
+    return mask;
+}
+
+bool Process::is_readable(uintptr_t address, size_t size) {
+    if (m_num_bad_pages == 0 || size == 0) {
+        return true;
+    }
+
+    auto now = std::chrono::steady_clock::now();
+    std::shared_lock _{m_bad_pages_lock};
+
+    for (auto page = page_of(address); page <= page_of(address + size - 1); page += page_size) {
+        if (auto it = m_bad_pages.find(page); it != m_bad_pages.end() && now - it->second < bad_page_lifetime) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void Process::mark_bad_page(uintptr_t page) {
+    std::unique_lock _{m_bad_pages_lock};
+    auto now = std::chrono::steady_clock::now();
+
+    // Forget pages that have expired so the map doesn't grow forever.
+    std::erase_if(m_bad_pages, [&](auto&& kv) { return now - kv.second >= bad_page_lifetime; });
+
+    m_bad_pages[page] = now;
+    m_num_bad_pages = m_bad_pages.size();
+}
+
+bool Process::PageMask::is_valid(uintptr_t address, size_t size) const {
+    if (size == 0) {
+        return true;
+    }
+
+    auto first = (page_of(address) - first_page) / page_size;
+    auto last = (page_of(address + size - 1) - first_page) / page_size;
+
+    if (address < first_page || last >= valid.size()) {
+        return false;
+    }
+
+    for (auto i = first; i <= last; ++i) {
+        if (!valid[i]) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void Process::read_batch(std::span<ReadRequest> requests) {
+    Trace::Scope trace{"read_batch", "memory"};
+
+    if (Trace::is_enabled()) {
+        size_t bytes{};
+
+        for (auto&& request : requests) {
+            bytes += request.size;
+        }
+
+        trace.arg("bytes", (int64_t)bytes);
+    }
 
-            // two incase the size causes overflow
-            if (offset >= ro_allocation.mem.size() || offset + size >= ro_allocation.mem.size()) {
-                return false;
+    // Requests separated by less than this many bytes get read together.
+    constexpr size_t max_gap = 0x100;
+    // Never coalesce into a single read larger than this.
+    constexpr size_t max_span = 0x10000;
+
+    std::vector<size_t> order(requests.size());
+
+    for (size_t i = 0; i < order.size(); ++i) {
+        order[i] = i;
+    }
+
+    std::sort(order.begin(), order.end(), [&](auto a, auto b) { return requests[a].address < requests[b].address; });
+
+    std::vector<std::byte> span_mem{};
+
+    for (size_t first = 0; first < order.size();) {
+        auto span_start = requests[order[first]].address;
+        auto span_end = span_start + requests[order[first]].size;
+        auto last = first + 1;
+
+        for (; last < order.size(); ++last) {
+            auto& next = requests[order[last]];
+            auto next_end = std::max(span_end, next.address + next.size);
+
+            if (next.address > span_end + max_gap || next_end - span_start > max_span) {
+                break;
             }
 
-            memcpy(buffer, ro_allocation.mem.data() + offset, size);
-            return true;
+            span_end = next_end;
         }
+
+        auto coalesced = false;
+
+        if (last - first > 1) {
+            span_mem.resize(span_end - span_start);
+            coalesced = read(span_start, span_mem.data(), span_mem.size());
+        }
+
+        for (auto i = first; i < last; ++i) {
+            auto& request = requests[order[i]];
+
+            if (coalesced) {
+                memcpy(request.buffer, span_mem.data() + (request.address - span_start), request.size);
+                request.ok = true;
+            } else {
+                // Either a lone request or part of the span isn't readable so fall back to reading individually.
+                request.ok = read(request.address, request.buffer, request.size);
+            }
+        }
+
+        first = last;
     }
+}
 
-    return handle_read(address, buffer, size);
+void Process::prefetch(uintptr_t address, size_t size) {
+    if (address == 0 || size == 0) {
+        return;
+    }
+
+    std::scoped_lock _{m_prefetch_lock};
+    m_prefetch_queue.emplace_back(address, size);
+}
+
+void Process::service_prefetches(size_t max_bytes, std::chrono::milliseconds refresh_rate) {
+    TRACE_SCOPE("service_prefetches", "scheduler");
+    // This runs on the UI thread so it never waits on the governor. Reads it would have to wait for fail right away (as
+    // canceled, see read_partial) and are left for a later tick.
+    static const std::atomic<bool> never_wait{true};
+    ReadGovernor::PriorityScope priority{ReadGovernor::Priority::Scan, &never_wait};
+    auto now = std::chrono::steady_clock::now();
+    std::vector<std::pair<uintptr_t, size_t>> queue{};
+    std::vector<ReadRequest> requests{};
+    std::vector<std::vector<std::byte>> buffers{};
+
+    {
+        std::scoped_lock _{m_prefetch_lock};
+
+        std::erase_if(m_prefetched, [&](auto&& kv) { return now - kv.second.time >= refresh_rate * 2; });
+        std::swap(queue, m_prefetch_queue);
+
+        size_t total_bytes{};
+
+        for (auto&& [address, size] : queue) {
+            if (total_bytes + size > max_bytes) {
+                break;
+            }
+
+            // Still fresh (or already queued this tick).
+            if (auto it = m_prefetched.find(address);
+                it != m_prefetched.end() && it->second.mem.size() >= size && now - it->second.time < refresh_rate) {
+                continue;
+            }
+
+            if (std::any_of(requests.begin(), requests.end(), [&](auto&& r) { return r.address == address; })) {
+                continue;
+            }
+
+            total_bytes += size;
+            buffers.emplace_back(size);
+            requests.emplace_back(ReadRequest{address, nullptr, size});
+        }
+    }
+
+    if (requests.empty()) {
+        return;
+    }
+
+    for (size_t i = 0; i < requests.size(); ++i) {
+        requests[i].buffer = buffers[i].data();
+    }
+
+    read_batch(requests);
+
+    std::scoped_lock _{m_prefetch_lock};
+
+    for (size_t i = 0; i < requests.size(); ++i) {
+        if (!requests[i].ok) {
+            continue;
+        }
+
+        auto& prefetched = m_prefetched[requests[i].address];
+        prefetched.mem = std::move(buffers[i]);
+        prefetched.time = now;
+        prefetched.usage.set(prefetched.mem.capacity());
+    }
+}
+
+bool Process::read_prefetched(uintptr_t address, void* buffer, size_t size, std::chrono::milliseconds max_age) {
+    auto now = std::chrono::steady_clock::now();
+    std::scoped_lock _{m_prefetch_lock};
+
+    if (auto it = m_prefetched.find(address);
+        it != m_prefetched.end() && it->second.mem.size() >= size && now - it->second.time < max_age) {
+        memcpy(buffer, it->second.mem.data(), size);
+        return true;
+    }
+
+    return false;
 }
 
 bool Process::write(uintptr_t address, const void* buffer, size_t size) {
@@ -51,3 +387,47 @@ const Process::Module* Process::get_module(std::string_view name) const {
 
     return nullptr;
 }
+
+std::chrono::steady_clock::time_point Process::last_used() const {
+    // The read-only cache is the only evictable in its category so there's nothing to order it against.
+    return {};
+}
+
+size_t Process::evict(size_t bytes_wanted) {
+    std::unique_lock _{m_read_only_lock};
+
+    // Drop the coldest allocations first. Reads that would have hit them go to the process again.
+    std::vector<ReadOnlyAllocation*> candidates{};
+
+    for (auto&& ro_allocation : m_read_only_allocations) {
+        if (!ro_allocation.mem.empty()) {
+            candidates.emplace_back(&ro_allocation);
+        }
+    }
+
+    std::sort(candidates.begin(), candidates.end(),
+        [](auto&& a, auto&& b) { return a->last_read->load() < b->last_read->load(); });
+
+    size_t freed{};
+
+    for (auto&& ro_allocation : candidates) {
+        if (freed >= bytes_wanted) {
+            break;
+        }
+
+        freed += ro_allocation->mem.capacity();
+        ro_allocation->mem.clear();
+        ro_allocation->mem.shrink_to_fit();
+        ro_allocation->usage.set(0);
+    }
+
+    return freed;
+}
+
+void Process::cache_read_only_allocation(ReadOnlyAllocation&& allocation) {
+    std::unique_lock _{m_read_only_lock};
+
+    allocation.usage.set(allocation.mem.capacity());
+    allocation.last_read->store(std::chrono::steady_clock::now().time_since_epoch().count());
+    m_read_only_allocations.emplace_back(std::move(allocation));
+}
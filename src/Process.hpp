@@ -1,11 +1,25 @@
 #pragma once
 
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <chrono>
 #include <cstdint>
+#include <memory>
+#include <mutex>
 #include <optional>
+#include <shared_mutex>
+#include <span>
 #include <string>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
-class Process {
+#include "MemoryAccountant.hpp"
+#include "ReadGovernor.hpp"
+#include "TargetPointer.hpp"
+
+class Process : public MemoryAccountant::Evictable {
 public:
     class Module {
     public:
@@ -25,16 +39,96 @@ public:
         bool execute{};
     };
 
+    // A polymorphic class found through RTTI.
+    struct RttiClass {
+        // Undecorated, eg. "app::Player".
+        std::string name{};
+        // Direct bases in declaration order.
+        std::vector<std::string> parents{};
+        // The complete object vtable.
+        uintptr_t vtable{};
+        size_t num_vfuncs{};
+    };
+
     struct ReadOnlyAllocation : public Allocation {
         // Read only allocations get cached.
         std::vector<std::byte> mem{};
+        MemoryAccountant::Usage usage{MemoryAccountant::Category::ReadOnlyCache};
+
+        // Set instead of mem when the backend maps the file the allocation comes from into our own address space. The
+        // mapping is owned by the backend, isn't accounted for and never gets evicted.
+        const std::byte* mapped{};
+
+        // Time (steady_clock ticks) of the last read served from mem. Used to find cold allocations to evict.
+        std::unique_ptr<std::atomic<int64_t>> last_read{std::make_unique<std::atomic<int64_t>>()};
+
+        // nullptr once evicted.
+        const std::byte* data() const {
+            if (mapped != nullptr) {
+                return mapped;
+            }
+
+            return mem.size() == size ? mem.data() : nullptr;
+        }
     };
 
+    static constexpr uintptr_t page_size = 0x1000;
+
+    // Which pages of a read_partial could be read. valid[i] covers the i'th page touched by the read (the first and
+    // last ones can be partially covered by the read).
+    struct PageMask {
+        uintptr_t first_page{};
+        std::vector<bool> valid{};
+        // Set when the read was canceled while waiting on the governor. The pages it didn't get to are invalid but
+        // weren't found to be unreadable.
+        bool canceled{};
+
+        bool all() const { return std::all_of(valid.begin(), valid.end(), [](bool v) { return v; }); }
+        bool none() const { return std::none_of(valid.begin(), valid.end(), [](bool v) { return v; }); }
+        bool is_valid(uintptr_t address, size_t size) const;
+    };
+
+    struct ReadRequest {
+        uintptr_t address{};
+        void* buffer{};
+        size_t size{};
+
+        // Set by read_batch.
+        bool ok{};
+    };
+
+    Process();
+    virtual ~Process();
+
     bool read(uintptr_t address, void* buffer, size_t size);
+
+    // Reads whatever pages of the range are readable. Unreadable pages are zeroed in buffer. Pages that fail to read
+    // are remembered for a while (see is_readable) so a range straddling an unmapped page costs a single read of the
+    // good pages on the next refresh rather than a failed read followed by a page by page retry.
+    PageMask read_partial(uintptr_t address, void* buffer, size_t size);
+
+    // False if any page of the range recently failed to read.
+    bool is_readable(uintptr_t address, size_t size);
+
+    // Reads many ranges at once. Requests that are close to each other are coalesced into a single read of the process
+    // so N nearby requests cost one round trip instead of N.
+    void read_batch(std::span<ReadRequest> requests);
     bool write(uintptr_t address, const void* buffer, size_t size);
+
+    // Speculative reads of memory that's likely to be displayed soon (eg. what the visible collapsed pointers point
+    // to). prefetch() queues a range, service_prefetches() reads up to max_bytes of the queue in one batch (the rest of
+    // the queue is dropped, it gets rebuilt every frame) and read_prefetched() serves a read from results younger than
+    // max_age so expanding or hovering a pointer doesn't have to wait on the process. Results are refreshed once
+    // they're older than refresh_rate and dropped once they're twice as old. Prefetches are read at scan priority.
+    void prefetch(uintptr_t address, size_t size);
+    void service_prefetches(size_t max_bytes, std::chrono::milliseconds refresh_rate);
+    bool read_prefetched(uintptr_t address, void* buffer, size_t size, std::chrono::milliseconds max_age);
+
     std::optional<uint64_t> protect(uintptr_t address, size_t size, uint64_t flags);
     std::optional<uintptr_t> allocate(uintptr_t address, size_t size, uint64_t flags);
     virtual uint32_t process_id() { return 0; }
+    // Total CPU time the process has used, for ReadGovernor's busy heuristic.
+    virtual std::optional<std::chrono::nanoseconds> cpu_time() { return std::nullopt; }
 
     // NOTE: Return true by default so you can view structures without being attached.
     virtual bool ok() { return true; }
@@ -42,6 +136,36 @@ public:
     // RTTI
     virtual std::optional<std::string> get_typename(uintptr_t ptr) { return std::nullopt; }
     virtual std::optional<std::string> get_typename_from_vtable(uintptr_t ptr) { return std::nullopt; }
+    // Every class with a vtable in module.
+    virtual std::vector<RttiClass> rtti_classes(const Module& module) { return {}; }
+
+    // How the target stores pointers, which isn't necessarily how we do (eg. a 32-bit process).
+    size_t pointer_size() const { return m_pointer_size; }
+    std::endian endianness() const { return m_endianness; }
+
+    // Calls fn with the TargetPointer for the target's layout. Loops over target memory should be templated on it and
+    // dispatched through here once rather than calling load_pointer per element.
+    template <typename Fn> decltype(auto) with_pointer(Fn&& fn) const {
+        return with_target_pointer(m_pointer_size, m_endianness, std::forward<Fn>(fn));
+    }
+
+    // For one-off pointers, eg. the one a node is displaying.
+    uintptr_t load_pointer(const void* p) const {
+        return with_pointer([p](auto ptr) { return decltype(ptr)::load(p); });
+    }
+
+    std::optional<uintptr_t> read_pointer(uintptr_t address) {
+        uint64_t out{};
+
+        if (!read(address, &out, m_pointer_size)) {
+            return std::nullopt;
+        }
+
+        return load_pointer(&out);
+    }
+
+    // Every read that isn't served from a cache goes through the governor first.
+    ReadGovernor& governor() { return m_governor; }
 
     auto&& modules() const { return m_modules; }
     auto&& allocations() const { return m_allocations; }
@@ -61,10 +185,48 @@ public:
 
     template <typename T> bool write(uintptr_t address, const T& value) { return write(address, &value, sizeof(T)); }
 
+    // MemoryAccountant::Evictable
+    std::chrono::steady_clock::time_point last_used() const override;
+    size_t evict(size_t bytes_wanted) override;
+
 protected:
     std::vector<Module> m_modules{};
     std::vector<Allocation> m_allocations{};
     std::vector<ReadOnlyAllocation> m_read_only_allocations{};
+    std::shared_mutex m_read_only_lock{};
+    ReadGovernor m_governor{[this] { return cpu_time(); }};
+    // Backends set these once in their constructor if the target differs from us.
+    size_t m_pointer_size{sizeof(uintptr_t)};
+    std::endian m_endianness{std::endian::native};
+
+    struct Prefetched {
+        std::vector<std::byte> mem{};
+        std::chrono::steady_clock::time_point time{};
+        MemoryAccountant::Usage usage{MemoryAccountant::Category::PointerBuffers};
+    };
+
+    // Pages that recently failed to read, and when they failed.
+    std::unordered_map<uintptr_t, std::chrono::steady_clock::time_point> m_bad_pages{};
+    std::shared_mutex m_bad_pages_lock{};
+    std::atomic<size_t> m_num_bad_pages{};
+
+    void mark_bad_page(uintptr_t page);
+
+    enum class ReadResult {
+        Ok,
+        Unreadable,
+        Canceled,
+    };
+
+    // read() that tells a read the governor canceled apart from one that failed.
+    ReadResult read_checked(uintptr_t address, void* buffer, size_t size);
+
+    std::mutex m_prefetch_lock{};
+    std::vector<std::pair<uintptr_t, size_t>> m_prefetch_queue{};
+    std::unordered_map<uintptr_t, Prefetched> m_prefetched{};
+
+    // Backends call this after filling in an allocation's mem so it gets accounted for.
+    void cache_read_only_allocation(ReadOnlyAllocation&& allocation);
 
     virtual bool handle_write(uintptr_t address, const void* buffer, size_t size) { return true; }
     virtual bool handle_read(uintptr_t address, void* buffer, size_t size) { return true; }
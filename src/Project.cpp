@@ -1,55 +1,49 @@
-#include "Project.hpp"
+#include <fstream>
 
-void to_json(nlohmann::json& j, const Project& p) {
-    std::function<void(nlohmann::json&, const std::string&, const node::Property&)> visit =
-        [&visit](nlohmann::json& j, const std::string& name, const node::Property& prop) {
-            if (prop.value.index() == 0 && prop.props.empty()) {
-                return;
-            }
-
-            if (prop.value != prop.default_value) {
-                std::visit(
-                    [&](auto&& value) {
-                        using T = std::decay_t<decltype(value)>;
-                        if constexpr (std::is_same_v<T, int>) {
-                            j[name] = value;
-                        } else if constexpr (std::is_same_v<T, bool>) {
-                            j[name] = value;
-                        }
-                    },
-                    prop.value);
-            }
+#include <spdlog/spdlog.h>
 
-            for (auto&& [child_name, child_prop] : prop.props) {
-                visit(j[name], child_name, child_prop);
-            }
-        };
+#include "Project.hpp"
 
-    std::function<void(nlohmann::json&)> erase_null = [&erase_null](nlohmann::json& j) {
-        if (!j.is_object()) {
-            return;
-        }
+static void write_props(nlohmann::json& j, const std::string& name, const node::Property& prop) {
+    if (prop.value.index() == 0 && prop.props.empty()) {
+        return;
+    }
 
-        for (auto it = j.begin(); it != j.end();) {
-            if (it->is_null()) {
-                it = j.erase(it);
-            } else {
-                erase_null(it.value());
-                ++it;
-            }
-        }
-    };
+    if (prop.value != prop.default_value) {
+        std::visit(
+            [&](auto&& value) {
+                using T = std::decay_t<decltype(value)>;
+                if constexpr (std::is_same_v<T, int>) {
+                    j[name] = value;
+                } else if constexpr (std::is_same_v<T, bool>) {
+                    j[name] = value;
+                }
+            },
+            prop.value);
+    }
 
-    j["props"].clear();
+    for (auto&& [child_name, child_prop] : prop.props) {
+        write_props(j[name], child_name, child_prop);
+    }
+}
 
-    for (auto&& [type_name, props] : p.props) {
-        visit(j["props"], type_name, props);
+static void erase_null(nlohmann::json& j) {
+    if (!j.is_object()) {
+        return;
     }
 
-    for (auto it = j["props"].begin(); it != j["props"].end(); ++it) {
-        erase_null(it.value());
+    for (auto it = j.begin(); it != j.end();) {
+        if (it->is_null()) {
+            it = j.erase(it);
+        } else {
+            erase_null(it.value());
+            ++it;
+        }
     }
+}
 
+void to_json(nlohmann::json& j, const Project& p) {
+    // Props are saved to their own files (see props_to_json).
     j["process"]["filter"] = p.process_filter;
     j["process"]["id"] = p.process_id;
     j["process"]["name"] = p.process_name;
@@ -69,26 +63,83 @@ void from_json(const nlohmann::json& j, Project& p) {
     p.type_chosen = j.at("type").value("chosen", "");
     p.props.clear();
 
-    std::function<void(const nlohmann::json&, node::Property&)> visit = [&visit](const nlohmann::json& j,
-                                                                            node::Property& prop) {
-        if (j.empty()) {
-            return;
+    // Projects saved before props got their own files have every type's props inline. They're all loaded and get
+    // written out to their own files on the next save.
+    if (auto props = j.find("props"); props != j.end()) {
+        for (auto it = props->begin(); it != props->end(); ++it) {
+            props_from_json(it.value(), p.props[it.key()]);
         }
+    }
+}
 
-        for (auto it = j.begin(); it != j.end(); ++it) {
-            auto& val = it.value();
+std::filesystem::path props_path(const std::filesystem::path& project_path, const std::string& type_name) {
+    auto dir = project_path;
+    dir.replace_extension("props");
+    return dir / (type_name + ".json");
+}
 
-            if (val.is_boolean()) {
-                prop[it.key()].value = (bool)val;
-            } else if (val.is_number()) {
-                prop[it.key()].value = (int)val;
-            } else if (val.is_object()) {
-                visit(val, prop.props[it.key()]);
+nlohmann::json props_to_json(const node::Property& props) {
+    nlohmann::json j{};
+
+    write_props(j, "props", props);
+
+    if (!j.contains("props")) {
+        return nlohmann::json::object();
+    }
+
+    erase_null(j["props"]);
+    return std::move(j["props"]);
+}
+
+void props_from_json(const nlohmann::json& j, node::Property& props) {
+    if (j.empty()) {
+        return;
+    }
+
+    for (auto it = j.begin(); it != j.end(); ++it) {
+        auto& val = it.value();
+
+        if (val.is_boolean()) {
+            props[it.key()].value = (bool)val;
+        } else if (val.is_number()) {
+            props[it.key()].value = (int)val;
+        } else if (val.is_object()) {
+            props_from_json(val, props.props[it.key()]);
+        }
+    }
+}
+
+void ProjectWriter::write(std::vector<File> files) {
+    // Keep the writes in order.
+    wait();
+
+    m_write = std::async(std::launch::async, [files = std::move(files)] {
+        for (auto&& [path, contents] : files) {
+            auto tmp_path = path;
+            tmp_path += ".tmp";
+
+            try {
+                std::filesystem::create_directories(path.parent_path());
+
+                {
+                    std::ofstream f{tmp_path, std::ios::binary};
+                    f << contents;
+
+                    if (!f) {
+                        throw std::runtime_error{"write failed"};
+                    }
+                }
+
+                std::filesystem::rename(tmp_path, path);
+            } catch (const std::exception& e) {
+                spdlog::error("Failed to save {}: {}", path.string(), e.what());
             }
         }
-    };
+    });
+}
 
-    for (auto it = j.at("props").begin(); it != j.at("props").end(); ++it) {
-        visit(it.value(), p.props[it.key()]);
+void ProjectWriter::wait() {
+    if (m_write.valid()) {
+        m_write.get();
     }
 }
@@ -1,7 +1,11 @@
 #pragma once
 
+#include <filesystem>
+#include <future>
 #include <map>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include <nlohmann/json.hpp>
 
@@ -13,6 +17,9 @@ struct Project {
     std::string process_filter{};
     uint32_t process_id{};
     std::string process_name{};
+    // Props of the types loaded so far. Every type's props are saved to their own file (see props_path) and only
+    // loaded once the type is selected, so opening and saving a project doesn't depend on how many types it has props
+    // for.
     std::map<std::string, node::Property> props{};
     std::map<std::string, std::string> type_addresses{};
     std::string type_chosen{};
@@ -20,3 +27,24 @@ struct Project {
 
 void to_json(nlohmann::json& j, const Project& p);
 void from_json(const nlohmann::json& j, Project& p);
+
+// foo.json -> foo.props/<type_name>.json
+std::filesystem::path props_path(const std::filesystem::path& project_path, const std::string& type_name);
+nlohmann::json props_to_json(const node::Property& props);
+void props_from_json(const nlohmann::json& j, node::Property& props);
+
+// Writes project files in the background. Each file is written to a temporary file that's then renamed over the old
+// one, so a crash in the middle of a save never leaves a truncated project behind.
+class ProjectWriter {
+public:
+    using File = std::pair<std::filesystem::path, std::string>;
+
+    ~ProjectWriter() { wait(); }
+
+    // Waits for the previous write (if any) so files are never written out of order.
+    void write(std::vector<File> files);
+    void wait();
+
+private:
+    std::future<void> m_write{};
+};
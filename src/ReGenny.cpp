@@ -1,6 +1,9 @@
 #include <algorithm>
 #include <cassert>
+#include <charconv>
+#include <cstring>
 #include <cstdlib>
+#include <random>
 #include <type_traits>
 
 #include <ppl.h>
@@ -17,8 +20,11 @@
 #include <spdlog/spdlog.h>
 
 #include "AboutUi.hpp"
+#include "Snapshot.hpp"
+#include "Trace.hpp"
 #include "Utility.hpp"
 #include "arch/Arch.hpp"
+#include "node/LayoutCache.hpp"
 #include "node/Undefined.hpp"
 
 #ifdef _WIN32
@@ -35,13 +41,28 @@ ReGenny::ReGenny(SDL_Window* window)
     spdlog::set_pattern("[%H:%M:%S] [%l] %v");
     spdlog::info("Start of log.");
 
-    reset_lua_state();
+    // Everything that isn't needed to draw the first frame (the Lua state, custom fonts, parsing files) is deferred.
+    m_startup_time = std::chrono::steady_clock::now();
+    spdlog::info("Startup: SDL and OpenGL initialized after {}ms", SDL_GetTicks());
+
+    auto phase_start = std::chrono::steady_clock::now();
+    auto end_phase = [&phase_start](std::string_view name) {
+        auto now = std::chrono::steady_clock::now();
+        spdlog::info("Startup: {} took {:.1f}ms", name,
+            std::chrono::duration<double, std::milli>{now - phase_start}.count());
+        phase_start = now;
+    };
 
     auto path_str = SDL_GetPrefPath("cursey", "ReGenny");
     m_app_path = path_str;
     SDL_free(path_str);
 
     load_cfg();
+    end_phase("Loading config");
+
+    register_rpc_methods();
+    update_rpc_server();
+    end_phase("Starting RPC server");
 
     m_triggers.on({SDLK_LCTRL, SDLK_N}, [this] { file_new(); });
     m_triggers.on({SDLK_LCTRL, SDLK_O}, [this] { file_open(); });
@@ -55,6 +76,17 @@ ReGenny::ReGenny(SDL_Window* window)
 }
 
 ReGenny::~ReGenny() {
+    m_rpc.stop();
+    cancel_snapshot_capture();
+
+    // Take ownership of the results of a parse that's still running so its template output gets cleaned up.
+    if (m_parse_future.valid()) {
+        try {
+            m_template_processing = m_parse_future.get().template_processing;
+        } catch (const std::exception&) {
+        }
+    }
+
     cleanup_template_processing();
 }
 
@@ -63,8 +95,10 @@ void ReGenny::process_event(SDL_Event& e) {
 }
 
 void ReGenny::update() {
-    if (m_load_font) {
+    // Custom fonts are only loaded after the first frame has been drawn with the default font.
+    if (m_load_font && ImGui::GetFrameCount() > 0) {
         spdlog::info("Setting font {}...", m_cfg.font_file);
+        auto font_start = std::chrono::steady_clock::now();
 
         auto& io = ImGui::GetIO();
         io.Fonts->Clear();
@@ -72,6 +106,19 @@ void ReGenny::update() {
         ImGui_ImplOpenGL3_DestroyFontsTexture();
         ImGui_ImplOpenGL3_CreateFontsTexture();
         m_load_font = false;
+
+        spdlog::info("Built font atlas in {:.1f}ms",
+            std::chrono::duration<double, std::milli>{std::chrono::steady_clock::now() - font_start}.count());
+    }
+
+    if (m_startup_time && ImGui::GetFrameCount() > 0) {
+        spdlog::info("Startup: first frame presented after {:.1f}ms",
+            std::chrono::duration<double, std::milli>{std::chrono::steady_clock::now() - *m_startup_time}.count());
+        m_startup_time = std::nullopt;
+    }
+
+    if (m_parse_future.valid() && m_parse_future.wait_for(0s) == std::future_status::ready) {
+        install_parsed_sdk();
     }
 
     auto now = std::chrono::system_clock::now();
@@ -93,6 +140,29 @@ void ReGenny::update() {
         save_cfg();
         m_cfg_save_time = std::nullopt;
     }
+
+    if (m_project_save_time && now > *m_project_save_time) {
+        save_project();
+    }
+
+    // Account for memory usage and evict from anything that's over budget.
+    if (auto steady_now = std::chrono::steady_clock::now(); steady_now >= m_next_memory_check_time) {
+        update_memory_usage();
+        m_next_memory_check_time = steady_now + 1s;
+    }
+
+    m_rpc.process_requests();
+
+    if (m_watches.size() != 0) {
+        std::scoped_lock _{m_lua_lock};
+        m_watches.update(*m_process);
+    }
+
+    // Prefetching is the lowest priority work so it goes last.
+    if (m_process != nullptr && m_cfg.prefetch_budget > 0) {
+        m_process->service_prefetches(
+            (size_t)m_cfg.prefetch_budget * 1024, std::chrono::milliseconds{m_cfg.refresh_rate});
+    }
 }
 
 void ReGenny::ui() {
@@ -121,6 +191,7 @@ void ReGenny::ui() {
         ImGui::DockBuilderDockWindow("Memory View", left);
         ImGui::DockBuilderDockWindow("Editor", right);
         ImGui::DockBuilderDockWindow("Log", bottom_top);
+        ImGui::DockBuilderDockWindow("Memory", bottom_top);
         ImGui::DockBuilderDockWindow("LuaEval", bottom_bottom);
 
         ImGui::DockBuilderFinish(dock);
@@ -197,6 +268,85 @@ void ReGenny::ui() {
         ImGui::EndPopup();
     }
 
+    m_ui.compare_popup = ImGui::GetID("Compare Instances");
+
+    ImGui::SetNextWindowSize(ImVec2(m_window_w * 0.9f, m_window_h * 0.9f), ImGuiCond_Appearing);
+    ImGui::SetNextWindowPos(ImVec2{m_window_w / 2.0f, m_window_h / 2.0f}, ImGuiCond_Appearing, ImVec2{0.5f, 0.5f});
+
+    if (ImGui::BeginPopupModal("Compare Instances")) {
+        if (ImGui::Button("Close")) {
+            ImGui::CloseCurrentPopup();
+        }
+
+        m_compare_ui.ui(*m_process, dynamic_cast<sdkgenny::Struct*>(m_type), m_is_address_valid ? m_address : 0);
+
+        ImGui::EndPopup();
+    }
+
+    m_ui.layout_popup = ImGui::GetID("Layout Analysis");
+
+    ImGui::SetNextWindowSize(ImVec2(m_window_w * 0.9f, m_window_h * 0.9f), ImGuiCond_Appearing);
+    ImGui::SetNextWindowPos(ImVec2{m_window_w / 2.0f, m_window_h / 2.0f}, ImGuiCond_Appearing, ImVec2{0.5f, 0.5f});
+
+    if (ImGui::BeginPopupModal("Layout Analysis")) {
+        if (ImGui::Button("Close")) {
+            ImGui::CloseCurrentPopup();
+        }
+
+        m_layout_ui.ui(m_sdk.get(), dynamic_cast<sdkgenny::Struct*>(m_type),
+            m_mem_ui != nullptr ? &m_mem_ui->change_counts() : nullptr);
+
+        ImGui::EndPopup();
+    }
+
+    m_ui.type_search_popup = ImGui::GetID("Type Search");
+
+    ImGui::SetNextWindowSize(ImVec2(m_window_w * 0.9f, m_window_h * 0.9f), ImGuiCond_Appearing);
+    ImGui::SetNextWindowPos(ImVec2{m_window_w / 2.0f, m_window_h / 2.0f}, ImGuiCond_Appearing, ImVec2{0.5f, 0.5f});
+
+    if (ImGui::BeginPopupModal("Type Search")) {
+        if (ImGui::Button("Close")) {
+            ImGui::CloseCurrentPopup();
+        }
+
+        if (auto address = m_type_search_ui.ui(*m_process, dynamic_cast<sdkgenny::Struct*>(m_type))) {
+            m_ui.address = fmt::format("0x{:X}", *address);
+            set_address();
+        }
+
+        ImGui::EndPopup();
+    }
+
+    m_ui.rtti_export_popup = ImGui::GetID("Export RTTI Classes");
+
+    ImGui::SetNextWindowPos(ImVec2{m_window_w / 2.0f, m_window_h / 2.0f}, ImGuiCond_Appearing, ImVec2{0.5f, 0.5f});
+
+    if (ImGui::BeginPopupModal("Export RTTI Classes", nullptr, ImGuiWindowFlags_AlwaysAutoResize)) {
+        if (ImGui::Button("Close")) {
+            ImGui::CloseCurrentPopup();
+        }
+
+        m_rtti_export_ui.ui(*m_process);
+
+        ImGui::EndPopup();
+    }
+
+    m_ui.snapshot_popup = ImGui::GetID("Capture Snapshot");
+
+    ImGui::SetNextWindowPos(ImVec2{m_window_w / 2.0f, m_window_h / 2.0f}, ImGuiCond_Appearing, ImVec2{0.5f, 0.5f});
+
+    if (ImGui::BeginPopupModal("Capture Snapshot", nullptr, ImGuiWindowFlags_AlwaysAutoResize)) {
+        snapshot_ui();
+
+        ImGui::SameLine();
+
+        if (ImGui::Button("Cancel")) {
+            ImGui::CloseCurrentPopup();
+        }
+
+        ImGui::EndPopup();
+    }
+
     ImGui::Begin("Memory View");
     memory_ui();
     ImGui::End();
@@ -205,6 +355,10 @@ void ReGenny::ui() {
     m_logger.ui();
     ImGui::End();
 
+    ImGui::Begin("Memory");
+    memory_usage_ui();
+    ImGui::End();
+
     ImGui::Begin("LuaEval");
 
     ImGui::BeginChild("luaeval");
@@ -249,22 +403,24 @@ void ReGenny::ui() {
         m_eval_history_index = m_eval_history.size();
 
         try {
+            TRACE_SCOPE("eval", "lua");
+
             if (std::string_view{eval.data()} == "clear") {
                 m_logger.clear();
             } else {
-                auto result = m_lua->safe_script(std::string{"return "} + eval.data());
+                auto result = lua().safe_script(std::string{"return "} + eval.data());
 
                 if (!result.valid()) {
-                    result = m_lua->safe_script(eval.data());
+                    result = lua().safe_script(eval.data());
 
                     if (!result.valid()) {
-                        sol::script_default_on_error(*m_lua, std::move(result));
+                        sol::script_default_on_error(lua(), std::move(result));
                     }
                 } else {
                     auto obj = result.get<sol::object>();
 
                     obj.push();
-                    auto str = luaL_tolstring(*m_lua, -1, nullptr);
+                    auto str = luaL_tolstring(lua(), -1, nullptr);
 
                     if (str != nullptr) {
                         spdlog::info("{}", str);
@@ -277,10 +433,10 @@ void ReGenny::ui() {
             if (std::string_view{e.what()}.find("<eof>") != std::string_view::npos) {
                 // Try again without the return
                 try {
-                    auto result = m_lua->safe_script(eval.data());
+                    auto result = lua().safe_script(eval.data());
 
                     if (!result.valid()) {
-                        sol::script_default_on_error(*m_lua, std::move(result));
+                        sol::script_default_on_error(lua(), std::move(result));
                     }
                 } catch (const std::exception& e) {
                     spdlog::error("{}", e.what());
@@ -484,6 +640,26 @@ void ReGenny::menu_ui() {
                 ImGui::OpenPopup(m_ui.module_memory_scan_popup);
             }
 
+            if (ImGui::MenuItem("Compare Instances")) {
+                ImGui::OpenPopup(m_ui.compare_popup);
+            }
+
+            if (ImGui::MenuItem("Analyze Layout")) {
+                ImGui::OpenPopup(m_ui.layout_popup);
+            }
+
+            if (ImGui::MenuItem("Search For Instances")) {
+                ImGui::OpenPopup(m_ui.type_search_popup);
+            }
+
+            if (ImGui::MenuItem("Export RTTI Classes")) {
+                ImGui::OpenPopup(m_ui.rtti_export_popup);
+            }
+
+            if (ImGui::MenuItem("Capture Snapshot")) {
+                ImGui::OpenPopup(m_ui.snapshot_popup);
+            }
+
             ImGui::EndDisabled();
             ImGui::EndMenu();
         }
@@ -502,11 +678,57 @@ void ReGenny::menu_ui() {
                 m_cfg_save_time = std::chrono::system_clock::now() + 1s;
             }
 
+            if (ImGui::SliderInt("Prefetch budget (KiB)", &m_cfg.prefetch_budget, 0, 1024)) {
+                m_cfg_save_time = std::chrono::system_clock::now() + 1s;
+            }
+
+            // | rather than || so every slider gets drawn.
+            if (ImGui::SliderInt("Read limit (KiB/s)", &m_cfg.read_limit_kib, 0, 65536) |
+                ImGui::SliderInt("Read limit (reads/s)", &m_cfg.read_limit_reads, 0, 10000) |
+                ImGui::SliderInt("Pause scans at target CPU %", &m_cfg.scan_busy_threshold, 0, 100)) {
+                update_read_limits();
+                m_cfg_save_time = std::chrono::system_clock::now() + 1s;
+            }
+
             if (ImGui::Checkbox("Always on top", &m_cfg.always_on_top)) {
                 save_cfg();
                 SDL_SetWindowAlwaysOnTop(m_window, m_cfg.always_on_top ? true : false);
             }
 
+            if (ImGui::Checkbox("RPC server", &m_cfg.rpc_enabled)) {
+                save_cfg();
+                update_rpc_server();
+            }
+
+            ImGui::BeginDisabled(m_rpc.is_running());
+
+            if (ImGui::InputInt("RPC port", &m_cfg.rpc_port)) {
+                m_cfg.rpc_port = std::clamp(m_cfg.rpc_port, 1, 65535);
+                m_cfg_save_time = std::chrono::system_clock::now() + 1s;
+            }
+
+            ImGui::EndDisabled();
+
+            if (m_rpc.is_running() && ImGui::MenuItem("Copy RPC Token")) {
+                ImGui::SetClipboardText(m_cfg.rpc_token.c_str());
+            }
+
+            if (!Trace::is_enabled()) {
+                if (ImGui::MenuItem("Start Trace")) {
+                    Trace::get().start();
+                }
+            } else if (ImGui::MenuItem("Stop Trace...")) {
+                nfdchar_t* trace_path{};
+
+                if (NFD_SaveDialog("json", nullptr, &trace_path) == NFD_OKAY) {
+                    std::filesystem::path path{trace_path};
+
+                    path.replace_extension("json");
+                    Trace::get().stop(path);
+                    free(trace_path);
+                }
+            }
+
             ImGui::EndMenu();
         }
 
@@ -524,7 +746,7 @@ void ReGenny::menu_ui() {
 
 void ReGenny::file_reload() {
     // Check if a file was modified
-    if (m_open_filepath.empty() || m_sdk == nullptr) {
+    if (m_open_filepath.empty() || m_sdk == nullptr || m_parse_future.valid()) {
         return;
     }
 
@@ -552,19 +774,7 @@ void ReGenny::file_reload() {
     }
 
     for (auto&& filepath : m_sdk->imports()) {
-        std::filesystem::path path_to_check = filepath;
-
-        if (m_template_processing) {
-            auto lookup = m_template_processing->m_processed_to_original.find(filepath);
-
-            if (lookup == m_template_processing->m_processed_to_original.end()) {
-                lookup = m_template_processing->m_processed_to_original.find(filepath.lexically_normal());
-            }
-
-            if (lookup != m_template_processing->m_processed_to_original.end()) {
-                path_to_check = lookup->second;
-            }
-        }
+        auto path_to_check = original_path(filepath);
 
         if (!std::filesystem::exists(path_to_check)) {
             continue;
@@ -643,6 +853,9 @@ void ReGenny::load_project() {
 
     spdlog::info("Opening project {}...", project_filepath.string());
 
+    m_saved_props.clear();
+    m_project_save_time = std::nullopt;
+
     try {
         std::ifstream f{project_filepath};
         nlohmann::json j{};
@@ -653,7 +866,15 @@ void ReGenny::load_project() {
         spdlog::error(e.what());
     }
 
-    if (m_process->process_id() == 0) { // Invalid PID (aka not attached).
+    // Bundles made by Capture Snapshot open in their snapshot instead of a process.
+    if (auto snapshot_filepath = snapshot_path(m_open_filepath); std::filesystem::exists(snapshot_filepath)) {
+        open_snapshot(snapshot_filepath);
+    } else if (m_process->process_id() == 0) { // Invalid PID (aka not attached).
+        if (dynamic_cast<SnapshotProcess*>(m_process.get()) != nullptr) {
+            m_process = std::make_unique<Process>();
+            node::Pointer::clear_rtti_cache();
+        }
+
         attach();
     }
 
@@ -674,19 +895,82 @@ void ReGenny::file_save() {
 }
 
 void ReGenny::save_project() {
+    m_project_save_time = std::nullopt;
+
+    if (m_open_filepath.empty()) {
+        return;
+    }
+
     auto proj_filepath = m_open_filepath;
 
     proj_filepath.replace_extension("json");
     spdlog::info("Saving {}...", proj_filepath.string());
 
+    if (m_mem_ui != nullptr) {
+        m_project.props[m_project.type_chosen] = m_mem_ui->props();
+    }
+
+    std::vector<ProjectWriter::File> files{};
+
     try {
-        std::ofstream f{proj_filepath, std::ofstream::out};
         nlohmann::json j = m_project;
 
-        f << std::setw(4) << j;
+        files.emplace_back(proj_filepath, j.dump(4));
+
+        // Only the loaded types whose props changed since they were loaded (or last saved) get written.
+        for (auto&& [type_name, props] : m_project.props) {
+            auto contents = props_to_json(props).dump(4);
+            auto hash = std::hash<std::string>{}(contents);
+
+            if (auto it = m_saved_props.find(type_name);
+                it != m_saved_props.end() ? it->second == hash : contents == "{}") {
+                continue;
+            }
+
+            m_saved_props[type_name] = hash;
+            files.emplace_back(props_path(proj_filepath, type_name), std::move(contents));
+        }
     } catch (const nlohmann::json::exception& e) {
         spdlog::error(e.what());
+        return;
+    }
+
+    m_project_writer.write(std::move(files));
+}
+
+node::Property& ReGenny::type_props(const std::string& type_name) {
+    if (auto it = m_project.props.find(type_name); it != m_project.props.end()) {
+        return it->second;
+    }
+
+    auto& props = m_project.props[type_name];
+
+    if (m_open_filepath.empty()) {
+        return props;
+    }
+
+    auto proj_filepath = m_open_filepath;
+    proj_filepath.replace_extension("json");
+
+    auto path = props_path(proj_filepath, type_name);
+    std::error_code ec{};
+
+    if (!std::filesystem::exists(path, ec)) {
+        return props;
+    }
+
+    try {
+        std::ifstream f{path};
+        nlohmann::json j{};
+
+        f >> j;
+        props_from_json(j, props);
+        m_saved_props[type_name] = std::hash<std::string>{}(props_to_json(props).dump(4));
+    } catch (const nlohmann::json::exception& e) {
+        spdlog::error("{}: {}", path.string(), e.what());
     }
+
+    return props;
 }
 
 void ReGenny::file_save_as() {
@@ -696,8 +980,26 @@ void ReGenny::file_save_as() {
         return;
     }
 
-    m_open_filepath = save_path;
-    m_open_filepath.replace_extension("genny");
+    std::filesystem::path new_filepath{save_path};
+    new_filepath.replace_extension("genny");
+
+    // Only changed props get written by save_project, so the new project would be missing every type that isn't
+    // loaded or hasn't changed. Load them all from the old project and write every one of them to the new one.
+    if (!m_open_filepath.empty() && new_filepath != m_open_filepath) {
+        auto props_dir = m_open_filepath;
+        props_dir.replace_extension("props");
+        std::error_code ec{};
+
+        for (auto&& entry : std::filesystem::directory_iterator{props_dir, ec}) {
+            if (entry.path().extension() == ".json") {
+                type_props(entry.path().stem().string());
+            }
+        }
+
+        m_saved_props.clear();
+    }
+
+    m_open_filepath = new_filepath;
 
     spdlog::info("Saving as {}...", m_open_filepath.string());
 
@@ -734,7 +1036,8 @@ void ReGenny::file_run_lua_script() {
     }
 
     try {
-        m_lua->do_file(lua_path);
+        TRACE_SCOPE("run_script", "lua");
+        lua().do_file(lua_path);
     } catch (const std::exception& e) {
         spdlog::error(e.what());
         return;
@@ -746,9 +1049,13 @@ void ReGenny::file_run_lua_script() {
 
 void ReGenny::action_detach() {
     spdlog::info("Detaching...");
+    m_type_search_ui.cancel();
+    m_rtti_export_ui.cancel();
+    cancel_snapshot_capture();
     m_process = std::make_unique<Process>();
+    node::Pointer::clear_rtti_cache();
     m_mem_ui = std::make_unique<MemoryUi>(
-        m_cfg, *m_sdk, dynamic_cast<sdkgenny::Struct*>(m_type), *m_process, m_project.props[m_project.type_chosen]);
+        m_cfg, *m_sdk, dynamic_cast<sdkgenny::Struct*>(m_type), *m_process, type_props(m_project.type_chosen));
     m_ui.processes.clear();
     set_window_title();
 }
@@ -835,7 +1142,11 @@ void ReGenny::attach() {
 
     spdlog::info("Attaching to {} PID: {}...", m_project.process_name, m_project.process_id);
 
+    m_type_search_ui.cancel();
+    m_rtti_export_ui.cancel();
+    cancel_snapshot_capture();
     m_process = arch::open_process(m_project.process_id);
+    node::Pointer::clear_rtti_cache();
     m_mem_ui = nullptr;
 
     if (!m_process->ok()) {
@@ -845,10 +1156,161 @@ void ReGenny::attach() {
         return;
     }
 
+    update_read_limits();
     parse_file();
     set_window_title();
 }
 
+void ReGenny::action_capture_snapshot() {
+    auto struct_ = dynamic_cast<sdkgenny::Struct*>(m_type);
+
+    if (struct_ == nullptr || !m_is_address_valid || m_open_filepath.empty() || m_snapshot_capture.valid()) {
+        return;
+    }
+
+    nfdchar_t* bundle_path{};
+
+    if (NFD_PickFolder(nullptr, &bundle_path) != NFD_OKAY) {
+        return;
+    }
+
+    std::filesystem::path bundle_dir{bundle_path};
+    auto root_dir = m_open_filepath.parent_path();
+    std::error_code ec{};
+
+    free(bundle_path);
+
+    if (std::filesystem::equivalent(bundle_dir, root_dir, ec)) {
+        m_ui.error_msg = "Pick a folder other than the one the file is in!";
+        ImGui::OpenPopup(m_ui.error_popup);
+        return;
+    }
+
+    // The .genny files keep their place relative to the opened one so the imports still resolve.
+    std::set<std::filesystem::path> sources{m_open_filepath.lexically_normal()};
+
+    for (auto&& import : m_sdk->imports()) {
+        sources.emplace(original_path(import).lexically_normal());
+    }
+
+    // The project points at the captured address and forgets the process so opening the bundle never attaches.
+    auto project = m_project;
+
+    project.process_id = 0;
+    project.process_name.clear();
+    project.type_addresses = {{m_project.type_chosen, fmt::format("0x{:X}", m_address)}};
+
+    if (m_mem_ui != nullptr) {
+        project.props[m_project.type_chosen] = m_mem_ui->props();
+    }
+
+    spdlog::info(
+        "Capturing {} at 0x{:X} ({} pointers deep)...", m_project.type_chosen, m_address, m_cfg.snapshot_depth);
+
+    // Everything that could change while it runs has been copied. The process and the sdk the type belongs to are only
+    // replaced after cancel_snapshot_capture.
+    m_snapshot_cancel = false;
+    m_snapshot_progress = 0.0f;
+    auto bundle_filepath = bundle_dir / m_open_filepath.filename();
+
+    m_snapshot_capture = std::async(std::launch::async, &ReGenny::save_bundle, this, struct_, m_address,
+        m_cfg.snapshot_depth, std::move(bundle_filepath), root_dir, std::move(sources), std::move(project));
+}
+
+void ReGenny::save_bundle(sdkgenny::Struct* struct_, uintptr_t address, int depth,
+    std::filesystem::path bundle_filepath, std::filesystem::path root_dir, std::set<std::filesystem::path> sources,
+    Project project) {
+    auto start = std::chrono::steady_clock::now();
+    auto snapshot = Snapshot::capture(*m_process, struct_, address, depth, m_snapshot_cancel, m_snapshot_progress);
+
+    if (!snapshot) {
+        spdlog::info("Snapshot capture cancelled");
+        return;
+    }
+
+    if (snapshot->truncated) {
+        spdlog::warn("Stopped capturing at {} MiB, lower the pointer depth to capture everything reachable",
+            Snapshot::max_bytes / 1024 / 1024);
+    }
+
+    auto bundle_dir = bundle_filepath.parent_path();
+    std::error_code ec{};
+
+    for (auto&& source : sources) {
+        auto relative = source.lexically_relative(root_dir);
+
+        if (relative.empty() || *relative.begin() == "..") {
+            spdlog::warn("{} isn't under {} so it's been left out of the bundle", source.string(), root_dir.string());
+            continue;
+        }
+
+        auto dest = bundle_dir / relative;
+
+        std::filesystem::create_directories(dest.parent_path(), ec);
+
+        if (!std::filesystem::copy_file(source, dest, std::filesystem::copy_options::overwrite_existing, ec)) {
+            spdlog::error("Failed to copy {} into the bundle: {}", source.string(), ec.message());
+            return;
+        }
+    }
+
+    auto project_filepath = bundle_filepath;
+
+    project_filepath.replace_extension("json");
+
+    std::vector<ProjectWriter::File> files{};
+
+    try {
+        nlohmann::json j = project;
+
+        files.emplace_back(project_filepath, j.dump(4));
+
+        for (auto&& [type_name, props] : project.props) {
+            files.emplace_back(props_path(project_filepath, type_name), props_to_json(props).dump(4));
+        }
+    } catch (const nlohmann::json::exception& e) {
+        spdlog::error(e.what());
+        return;
+    }
+
+    ProjectWriter{}.write(std::move(files));
+
+    if (!snapshot->save(snapshot_path(bundle_filepath))) {
+        return;
+    }
+
+    spdlog::info("Saved {} ({:.1f} MiB in {} ranges, {} RTTI names) in {:.1f}s", bundle_filepath.string(),
+        snapshot->num_bytes() / 1024.0 / 1024.0, snapshot->ranges.size(), snapshot->typenames.size(),
+        std::chrono::duration<double>{std::chrono::steady_clock::now() - start}.count());
+}
+
+void ReGenny::cancel_snapshot_capture() {
+    if (m_snapshot_capture.valid()) {
+        m_snapshot_cancel = true;
+        m_snapshot_capture.wait();
+    }
+}
+
+void ReGenny::open_snapshot(const std::filesystem::path& path) {
+    auto snapshot = Snapshot::load(path);
+
+    if (!snapshot) {
+        m_ui.error_msg = "Couldn't open the snapshot!";
+        ImGui::OpenPopup(m_ui.error_popup);
+        return;
+    }
+
+    spdlog::info("Opening snapshot {} ({:.1f} MiB)...", path.string(), snapshot->num_bytes() / 1024.0 / 1024.0);
+
+    m_type_search_ui.cancel();
+    m_rtti_export_ui.cancel();
+    cancel_snapshot_capture();
+    m_process = std::make_unique<SnapshotProcess>(std::move(*snapshot));
+    node::Pointer::clear_rtti_cache();
+    m_mem_ui = nullptr;
+    update_read_limits();
+}
+
 void ReGenny::module_memory_scan_ui() {
     if (m_process == nullptr || !m_process->ok() || m_process->process_id() == 0) {
         ImGui::Text("Error: No Process");
@@ -918,6 +1380,9 @@ void ReGenny::module_memory_scan_ui() {
 }
 
 void ReGenny::scan_module_memory() {
+    // Runs on a thread of its own, in the background as far as the governor is concerned.
+    ReadGovernor::PriorityScope priority{ReadGovernor::Priority::Scan};
+
     if (m_ui.selected_module.name.empty() || m_ui.selected_module.size == 0) {
         m_ui.module_scan_text = "No module selected or invalid module";
         return;
@@ -939,53 +1404,54 @@ void ReGenny::scan_module_memory() {
     
     // Scan memory for RTTI objects
     std::unordered_map<std::string, std::vector<uintptr_t>> found_objects;
-    size_t ptr_size = sizeof(void*);
-    size_t total_pointers = (module_memory.size() - ptr_size) / ptr_size;
-    size_t counter = 0;
+    m_process->with_pointer([&]<typename Ptr>(Ptr) {
+        size_t ptr_size = Ptr::size;
+        size_t total_pointers = (module_memory.size() - ptr_size) / ptr_size;
+        size_t counter = 0;
     
-    // Start scanning at aligned addresses
-    for (size_t i = 0; i <= module_memory.size() - ptr_size; i += ptr_size) {
-        // Update progress every 10000 iterations to avoid UI overhead
-        if (++counter % 10000 == 0) {
-            m_ui.module_scan_progress = static_cast<float>(i) / static_cast<float>(module_memory.size());
-        }
-        
-        // Get pointer value from memory
-        uintptr_t ptr_value = 0;
-        std::memcpy(&ptr_value, module_memory.data() + i, ptr_size);
+        // Start scanning at aligned addresses
+        for (size_t i = 0; i <= module_memory.size() - ptr_size; i += ptr_size) {
+            // Update progress every 10000 iterations to avoid UI overhead
+            if (++counter % 10000 == 0) {
+                m_ui.module_scan_progress = static_cast<float>(i) / static_cast<float>(module_memory.size());
+            }
         
-        // Skip null or obviously invalid pointers
-        if (ptr_value == 0 || ptr_value < 0x10000) {
-            continue;
-        }
+            // Get pointer value from memory
+            auto ptr_value = Ptr::load(module_memory.data() + i);
         
-        // Check if this could be a valid pointer within the process address space
-        for (size_t j = 0; j < 2; ++j) {
-            const auto tname = m_process->get_typename(j == 0 ? m_ui.selected_module.start + i : ptr_value);
-            
-            if (!tname || tname->empty()) {
+            // Skip null or obviously invalid pointers
+            if (ptr_value == 0 || ptr_value < 0x10000) {
                 continue;
             }
+        
+            // Check if this could be a valid pointer within the process address space
+            for (size_t j = 0; j < 2; ++j) {
+                const auto tname = m_process->get_typename(j == 0 ? m_ui.selected_module.start + i : ptr_value);
             
-            // Filter based on search term if provided
-            if (!m_ui.module_scan_search_name.empty() && 
-                tname->find(m_ui.module_scan_search_name) == std::string::npos) {
-                continue;
-            }
+                if (!tname || tname->empty()) {
+                    continue;
+                }
             
-            // Store the result
-            found_objects[*tname].push_back(m_ui.selected_module.start + i);
+                // Filter based on search term if provided
+                if (!m_ui.module_scan_search_name.empty() && 
+                    tname->find(m_ui.module_scan_search_name) == std::string::npos) {
+                    continue;
+                }
             
-            // Add to results (limit to prevent UI overload)
-            if (found_objects.size() < 10000) {
-                m_ui.module_scan_results.emplace_back(ModuleScanResult{
-                    .type_name = *tname,
-                    .address = m_ui.selected_module.start + i,
-                    .offset = i
-                });
+                // Store the result
+                found_objects[*tname].push_back(m_ui.selected_module.start + i);
+            
+                // Add to results (limit to prevent UI overload)
+                if (found_objects.size() < 10000) {
+                    m_ui.module_scan_results.emplace_back(ModuleScanResult{
+                        .type_name = *tname,
+                        .address = m_ui.selected_module.start + i,
+                        .offset = i
+                    });
+                }
             }
         }
-    }
+    });
     
     // Sort results by address
     std::sort(m_ui.module_scan_results.begin(), m_ui.module_scan_results.end(),
@@ -1052,28 +1518,32 @@ void ReGenny::rtti_sweep_ui() {
         std::vector<uint8_t> base_data(m_type->size());
         m_process->read(m_address, base_data.data(), base_data.size());
 
-        // for (size_t i = 0; i < base_data.size(); i += sizeof(void*)) {
-        concurrency::parallel_for(size_t{0}, base_data.size(), size_t{sizeof(void*)}, [&](size_t i) {
-            if (i + sizeof(void*) >= base_data.size()) {
-                return;
-            }
+        m_process->with_pointer([&]<typename Ptr>(Ptr) {
+            concurrency::parallel_for(size_t{0}, base_data.size(), size_t{Ptr::size}, [&](size_t i) {
+                // The priority is per thread so it's set in every body.
+                ReadGovernor::PriorityScope priority{ReadGovernor::Priority::Scan};
 
-            const auto deref = *(uintptr_t*)(base_data.data() + i);
+                if (i + Ptr::size >= base_data.size()) {
+                    return;
+                }
 
-            if (deref == 0) {
-                return;
-            }
+                const auto deref = Ptr::load(base_data.data() + i);
 
-            const auto tname = m_process->get_typename(deref);
+                if (deref == 0) {
+                    return;
+                }
 
-            if (!tname || tname->length() < 5) {
-                return;
-            }
+                const auto tname = m_process->get_typename(deref);
 
-            if (tname && tname->find(m_ui.rtti_sweep_search_name) != std::string::npos) {
-                std::scoped_lock _{m_ui.rtti_lock};
-                m_ui.rtti_sweep_text += fmt::format("struct {:s}* @ 0x{:x}\n", *tname, (uintptr_t)i);
-            }
+                if (!tname || tname->length() < 5) {
+                    return;
+                }
+
+                if (tname && tname->find(m_ui.rtti_sweep_search_name) != std::string::npos) {
+                    std::scoped_lock _{m_ui.rtti_lock};
+                    m_ui.rtti_sweep_text += fmt::format("struct {:s}* @ 0x{:x}\n", *tname, (uintptr_t)i);
+                }
+            });
         });
 
         struct Chain {
@@ -1104,39 +1574,41 @@ void ReGenny::rtti_sweep_ui() {
 
             std::recursive_mutex local_mutex{};
 
-            // for (size_t i = 0; i < data.size(); i += sizeof(void*)) {
-            concurrency::parallel_for(size_t{0}, data.size(), size_t{sizeof(void*)}, [&](size_t i) {
-                if (i + sizeof(void*) >= data.size()) {
-                    return;
-                }
+            m_process->with_pointer([&]<typename Ptr>(Ptr) {
+                concurrency::parallel_for(size_t{0}, data.size(), size_t{Ptr::size}, [&](size_t i) {
+                    ReadGovernor::PriorityScope priority{ReadGovernor::Priority::Scan};
 
-                const auto deref = *(uintptr_t*)(data.data() + i);
-
-                if (deref == 0) {
-                    return;
-                }
+                    if (i + Ptr::size >= data.size()) {
+                        return;
+                    }
 
-                const auto tname = m_process->get_typename(deref);
+                    const auto deref = Ptr::load(data.data() + i);
 
-                if (tname && tname->find(class_name) != std::string::npos) {
-                    std::string chain_string{};
-                    for (auto&& c : chain) {
-                        chain_string += fmt::format("0x{:x} -> ", c.offset);
+                    if (deref == 0) {
+                        return;
                     }
 
-                    std::scoped_lock _{local_mutex};
-                    // m_ui.rtti_sweep_text += fmt::format("struct {:s}* @ {:s} + 0x{:x}\n", *tname, chain_string, i);
-                    result.emplace_back(i, fmt::format("{:s}* @ {:s} + 0x{:x}\n", *tname, chain_string, i));
-                }
+                    const auto tname = m_process->get_typename(deref);
 
-                auto chain_copy = chain;
-                chain_copy.push_back({base, i});
-                const auto new_results = lookup(deref, 0x1000, chain_copy, class_name);
+                    if (tname && tname->find(class_name) != std::string::npos) {
+                        std::string chain_string{};
+                        for (auto&& c : chain) {
+                            chain_string += fmt::format("0x{:x} -> ", c.offset);
+                        }
 
-                if (!new_results.empty()) {
-                    std::scoped_lock _{local_mutex};
-                    result.insert(result.end(), new_results.begin(), new_results.end());
-                }
+                        std::scoped_lock _{local_mutex};
+                        result.emplace_back(i, fmt::format("{:s}* @ {:s} + 0x{:x}\n", *tname, chain_string, i));
+                    }
+
+                    auto chain_copy = chain;
+                    chain_copy.push_back({base, i});
+                    const auto new_results = lookup(deref, 0x1000, chain_copy, class_name);
+
+                    if (!new_results.empty()) {
+                        std::scoped_lock _{local_mutex};
+                        result.insert(result.end(), new_results.begin(), new_results.end());
+                    }
+                });
             });
 
             // std::sort(result.begin(), result.end(), [](auto&& a, auto&& b) { return a.offset < b.offset; });
@@ -1193,11 +1665,11 @@ void ReGenny::rtti_ui() {
         std::unordered_map<std::string, uint32_t> counts{};
 
         for (size_t i = 0; i < data.size(); i++) {
-            if (i + sizeof(void*) >= data.size()) {
+            if (i + m_process->pointer_size() >= data.size()) {
                 break;
             }
 
-            const auto deref = *(uintptr_t*)(data.data() + i);
+            const auto deref = m_process->load_pointer(data.data() + i);
 
             if (deref == 0) {
                 continue;
@@ -1240,6 +1712,57 @@ void ReGenny::rtti_ui() {
     }
 }
 
+void ReGenny::snapshot_ui() {
+    auto capturing = m_snapshot_capture.valid();
+
+    if (capturing && m_snapshot_capture.wait_for(0s) == std::future_status::ready) {
+        try {
+            m_snapshot_capture.get();
+        } catch (const std::exception& e) {
+            spdlog::error("Snapshot capture failed: {}", e.what());
+        }
+
+        capturing = false;
+    }
+
+    auto can_capture = dynamic_cast<sdkgenny::Struct*>(m_type) != nullptr && m_is_address_valid;
+
+    if (can_capture) {
+        ImGui::Text("Saves %s at %p, the memory reachable from it and the .genny files to a folder.",
+            m_project.type_chosen.c_str(), (void*)m_address);
+        ImGui::TextUnformatted("Opening the .genny file there shows the same view without the process.");
+    } else {
+        ImGui::TextUnformatted("Choose a type and a valid address to capture first.");
+    }
+
+    ImGui::BeginDisabled(capturing);
+
+    if (ImGui::InputInt("Pointer depth", &m_cfg.snapshot_depth)) {
+        m_cfg.snapshot_depth = std::clamp(m_cfg.snapshot_depth, 0, 64);
+        m_cfg_save_time = std::chrono::system_clock::now() + 1s;
+    }
+
+    ImGui::BeginDisabled(!can_capture || m_open_filepath.empty());
+
+    if (ImGui::Button("Save Bundle...")) {
+        action_capture_snapshot();
+    }
+
+    ImGui::EndDisabled();
+    ImGui::EndDisabled();
+
+    if (capturing) {
+        ImGui::SameLine();
+
+        if (ImGui::Button("Cancel")) {
+            m_snapshot_cancel = true;
+        }
+
+        ImGui::ProgressBar(m_snapshot_progress, ImVec2{-1.0f, 0.0f},
+            fmt::format("Capturing... {:.1f}%", m_snapshot_progress * 100.0f).c_str());
+    }
+}
+
 void ReGenny::update_address() {
     // If the parsed address has no offsets then it's not valid at all and there's nothing to update.
     if (m_parsed_address.offsets.empty()) {
@@ -1276,7 +1799,7 @@ void ReGenny::update_address() {
 
     // Dereference and add the offsets.
     for (auto it = m_parsed_address.offsets.begin() + 1; it != m_parsed_address.offsets.end(); ++it) {
-        m_address = m_process->read<uintptr_t>(m_address).value_or(0);
+        m_address = m_process->read_pointer(m_address).value_or(0);
 
         if (m_address == 0) {
             return;
@@ -1297,6 +1820,10 @@ void ReGenny::update_address() {
 void ReGenny::memory_ui() {
     // assert(m_process != nullptr);
 
+    if (m_parse_future.valid()) {
+        ImGui::TextDisabled("Parsing %s...", m_open_filepath.filename().string().c_str());
+    }
+
     if (ImGui::BeginCombo("Typename", m_project.type_chosen.c_str())) {
         for (auto&& type_name : m_ui.type_names) {
             auto is_selected = type_name == m_project.type_chosen;
@@ -1309,6 +1836,7 @@ void ReGenny::memory_ui() {
 
                 m_project.type_chosen = type_name;
                 set_type();
+                m_project_save_time = std::chrono::system_clock::now() + 1s;
             }
 
             if (is_selected) {
@@ -1339,6 +1867,489 @@ void ReGenny::memory_ui() {
     }
 }
 
+void ReGenny::update_memory_usage() {
+    size_t props_bytes{};
+
+    for (auto&& [type_name, props] : m_project.props) {
+        props_bytes += type_name.capacity() + props.memory_usage();
+    }
+
+    if (m_mem_ui != nullptr) {
+        props_bytes += m_mem_ui->props().memory_usage();
+    }
+
+    m_props_usage.set(props_bytes);
+
+    constexpr size_t mib = 1024 * 1024;
+    std::array<size_t, MemoryAccountant::num_categories> budgets{};
+
+    budgets[(size_t)MemoryAccountant::Category::ReadOnlyCache] = (size_t)m_cfg.budget_read_only_cache * mib;
+    budgets[(size_t)MemoryAccountant::Category::PointerBuffers] = (size_t)m_cfg.budget_pointer_buffers * mib;
+    budgets[(size_t)MemoryAccountant::Category::Log] = (size_t)m_cfg.budget_log * mib;
+
+    if (auto freed = MemoryAccountant::get().enforce_budgets(budgets); freed != 0) {
+        spdlog::debug("Evicted {} KiB to stay within memory budgets", freed / 1024);
+    }
+
+    m_ui.memory_load = m_helpers->memory_load();
+    m_ui.working_set = m_helpers->working_set();
+
+    // Warn once each time the host crosses the warning threshold so the user can act before it starts swapping.
+    if (m_ui.memory_load && *m_ui.memory_load >= (uint32_t)m_cfg.memory_warning_load) {
+        if (!m_ui.memory_warned) {
+            spdlog::warn(
+                "System memory load is at {}% (ReGenny is using {} MiB). Consider lowering the memory budgets.",
+                *m_ui.memory_load, m_ui.working_set.value_or(0) / mib);
+            m_ui.memory_warned = true;
+        }
+    } else {
+        m_ui.memory_warned = false;
+    }
+}
+
+void ReGenny::memory_usage_ui() {
+    constexpr auto mib = 1024.0 * 1024.0;
+    auto& accountant = MemoryAccountant::get();
+
+    if (m_ui.working_set) {
+        ImGui::Text("Working set: %.1f MiB", *m_ui.working_set / mib);
+    }
+
+    if (m_ui.memory_load) {
+        ImGui::SameLine();
+
+        if (*m_ui.memory_load >= (uint32_t)m_cfg.memory_warning_load) {
+            ImGui::TextColored({1.0f, 0.0f, 0.0f, 1.0f}, "System memory load: %u%%", *m_ui.memory_load);
+        } else {
+            ImGui::Text("System memory load: %u%%", *m_ui.memory_load);
+        }
+    }
+
+    ImGui::Text("Tracked: %.1f MiB", accountant.total_bytes() / mib);
+
+    if (auto& governor = m_process->governor(); governor.num_throttled() > 0 || governor.is_target_busy()) {
+        ImGui::Text("Throttled reads: %zu%s", governor.num_throttled(),
+            governor.is_target_busy() ? " (target busy, scans paused)" : "");
+    }
+
+    auto budget_for = [this](MemoryAccountant::Category category) -> int* {
+        switch (category) {
+        case MemoryAccountant::Category::ReadOnlyCache:
+            return &m_cfg.budget_read_only_cache;
+        case MemoryAccountant::Category::PointerBuffers:
+            return &m_cfg.budget_pointer_buffers;
+        case MemoryAccountant::Category::Log:
+            return &m_cfg.budget_log;
+        default:
+            return nullptr;
+        }
+    };
+
+    if (ImGui::BeginTable("MemoryUsage", 3, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg)) {
+        ImGui::TableSetupColumn("Category");
+        ImGui::TableSetupColumn("Used (MiB)");
+        ImGui::TableSetupColumn("Budget (MiB, 0 = unlimited)");
+        ImGui::TableHeadersRow();
+
+        for (size_t i = 0; i < MemoryAccountant::num_categories; ++i) {
+            auto category = (MemoryAccountant::Category)i;
+            auto name = MemoryAccountant::category_name(category);
+
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            ImGui::TextUnformatted(name.data(), name.data() + name.size());
+            ImGui::TableNextColumn();
+            ImGui::Text("%.2f", accountant.bytes(category) / mib);
+            ImGui::TableNextColumn();
+
+            if (auto budget = budget_for(category)) {
+                ImGui::PushID((int)i);
+                ImGui::SetNextItemWidth(-1.0f);
+
+                if (ImGui::InputInt("##budget", budget)) {
+                    *budget = std::max(*budget, 0);
+                    m_cfg_save_time = std::chrono::system_clock::now() + 1s;
+                }
+
+                ImGui::PopID();
+            } else {
+                ImGui::TextUnformatted("-");
+            }
+        }
+
+        ImGui::EndTable();
+    }
+
+    if (ImGui::SliderInt("Warning load", &m_cfg.memory_warning_load, 50, 100, "%d%%")) {
+        m_cfg_save_time = std::chrono::system_clock::now() + 1s;
+    }
+}
+
+namespace {
+struct ResolvedField {
+    uintptr_t offset{};
+    sdkgenny::Type* type{};
+    sdkgenny::Variable* var{};
+};
+
+// Resolves a dotted field path such as "transform.position[2]" to its offset from the start of struct_.
+std::optional<ResolvedField> resolve_field(sdkgenny::Struct* struct_, std::string_view path) {
+    ResolvedField field{.type = struct_};
+
+    while (!path.empty()) {
+        auto dot = path.find('.');
+        auto component = path.substr(0, dot);
+        path = dot == std::string_view::npos ? std::string_view{} : path.substr(dot + 1);
+
+        auto bracket = component.find('[');
+        auto name = component.substr(0, bracket);
+        auto parent = dynamic_cast<sdkgenny::Struct*>(field.type);
+
+        if (parent == nullptr) {
+            return std::nullopt;
+        }
+
+        std::vector<std::pair<uintptr_t, sdkgenny::Variable*>> variables{};
+        collect_variables(parent, 0, variables);
+
+        auto it = std::find_if(
+            variables.begin(), variables.end(), [&](auto&& variable) { return variable.second->name() == name; });
+
+        if (it == variables.end()) {
+            return std::nullopt;
+        }
+
+        field.offset += it->first;
+        field.type = it->second->type();
+        field.var = it->second;
+
+        // Index into (possibly multidimensional) arrays.
+        while (bracket != std::string_view::npos) {
+            auto close = component.find(']', bracket);
+            auto array = dynamic_cast<sdkgenny::Array*>(field.type);
+
+            if (close == std::string_view::npos || array == nullptr) {
+                return std::nullopt;
+            }
+
+            size_t index{};
+            auto index_str = component.substr(bracket + 1, close - bracket - 1);
+
+            if (std::from_chars(index_str.data(), index_str.data() + index_str.size(), index).ec != std::errc{} ||
+                index >= array->count()) {
+                return std::nullopt;
+            }
+
+            field.offset += index * array->of()->size();
+            field.type = array->of();
+            field.var = nullptr;
+            bracket = component.find('[', close);
+        }
+    }
+
+    return field;
+}
+
+template <typename T> T load(const std::byte* mem) {
+    T value{};
+    memcpy(&value, mem, sizeof(T));
+    return value;
+}
+
+uint64_t load_unsigned(const std::byte* mem, size_t size) {
+    switch (size) {
+    case 1:
+        return load<uint8_t>(mem);
+    case 2:
+        return load<uint16_t>(mem);
+    case 4:
+        return load<uint32_t>(mem);
+    case 8:
+        return load<uint64_t>(mem);
+    default:
+        return 0;
+    }
+}
+
+// Decodes a field the same way the memory view displays it, falling back to a hex string of its bytes.
+nlohmann::json decode_field(const ResolvedField& field, const std::byte* mem, size_t size) {
+    if (field.var != nullptr && field.var->is_bitfield()) {
+        auto value = load_unsigned(mem, size) >> field.var->bit_offset();
+        return value & ((1ull << field.var->bit_size()) - 1);
+    }
+
+    if (auto enum_ = dynamic_cast<sdkgenny::Enum*>(field.type)) {
+        auto value = load_unsigned(mem, size);
+        nlohmann::json j{{"value", value}};
+
+        for (auto&& [val_name, val_val] : enum_->values()) {
+            if (val_val == value) {
+                j["name"] = val_name;
+                break;
+            }
+        }
+
+        return j;
+    }
+
+    std::array<std::vector<std::string>*, 2> metadatas{
+        field.var != nullptr ? &field.var->metadata() : nullptr, &field.type->metadata()};
+
+    for (auto&& metadata : metadatas) {
+        if (metadata == nullptr) {
+            continue;
+        }
+
+        for (auto&& md : *metadata) {
+            if (md == "u8" && size >= 1) {
+                return load<uint8_t>(mem);
+            } else if (md == "u16" && size >= 2) {
+                return load<uint16_t>(mem);
+            } else if (md == "u32" && size >= 4) {
+                return load<uint32_t>(mem);
+            } else if (md == "u64" && size >= 8) {
+                return load<uint64_t>(mem);
+            } else if (md == "i8" && size >= 1) {
+                return load<int8_t>(mem);
+            } else if (md == "i16" && size >= 2) {
+                return load<int16_t>(mem);
+            } else if (md == "i32" && size >= 4) {
+                return load<int32_t>(mem);
+            } else if (md == "i64" && size >= 8) {
+                return load<int64_t>(mem);
+            } else if (md == "f32" && size >= 4) {
+                return load<float>(mem);
+            } else if (md == "f64" && size >= 8) {
+                return load<double>(mem);
+            } else if (md == "bool" && size >= 1) {
+                return load<bool>(mem);
+            }
+        }
+    }
+
+    if (field.type->is_a<sdkgenny::Pointer>()) {
+        return load_unsigned(mem, size);
+    }
+
+    std::string hex{};
+
+    for (size_t i = 0; i < size; ++i) {
+        fmt::format_to(std::back_inserter(hex), "{:02X}", (uint8_t)mem[i]);
+    }
+
+    return hex;
+}
+
+uintptr_t address_param(const nlohmann::json& params, const char* name) {
+    auto it = params.find(name);
+
+    if (it == params.end()) {
+        throw RpcServer::Error{RpcServer::invalid_params, fmt::format("Missing parameter '{}'", name)};
+    }
+
+    if (it->is_number_unsigned()) {
+        return it->get<uintptr_t>();
+    }
+
+    if (it->is_string()) {
+        try {
+            return std::stoull(it->get<std::string>(), nullptr, 0);
+        } catch (...) {
+        }
+    }
+
+    throw RpcServer::Error{RpcServer::invalid_params, fmt::format("Invalid address '{}'", it->dump())};
+}
+} // namespace
+
+void ReGenny::register_rpc_methods() {
+    m_rpc.add_method("get_state", [this](const nlohmann::json&) -> nlohmann::json {
+        return {
+            {"file", m_open_filepath.string()},
+            {"process_id", m_process->process_id()},
+            {"type", m_project.type_chosen},
+            {"address_expression", m_ui.address},
+            {"address", m_address},
+            {"address_valid", m_is_address_valid},
+        };
+    });
+
+    m_rpc.add_method("set_type", [this](const nlohmann::json& params) -> nlohmann::json {
+        auto name = params.value("name", ""s);
+
+        if (m_sdk == nullptr || !m_ui.type_names.contains(name)) {
+            throw RpcServer::Error{RpcServer::invalid_params, fmt::format("Unknown type '{}'", name)};
+        }
+
+        if (m_mem_ui != nullptr) {
+            m_project.props[m_project.type_chosen] = m_mem_ui->props();
+        }
+
+        m_project.type_chosen = name;
+        set_type();
+        m_project_save_time = std::chrono::system_clock::now() + 1s;
+
+        return m_type != nullptr;
+    });
+
+    m_rpc.add_method("set_address", [this](const nlohmann::json& params) -> nlohmann::json {
+        m_ui.address = params.value("address", ""s);
+        set_address();
+
+        // Resolve it now so the caller gets the result instead of the previous address.
+        m_next_address_refresh_time = {};
+        update_address();
+
+        return {{"address", m_address}, {"address_valid", m_is_address_valid}};
+    });
+
+    m_rpc.add_method("read", [this](const nlohmann::json& params) -> nlohmann::json {
+        constexpr size_t max_read_size = 1024 * 1024;
+        auto address = address_param(params, "address");
+        auto size = params.value("size", (size_t)0);
+
+        if (size == 0 || size > max_read_size) {
+            throw RpcServer::Error{RpcServer::invalid_params, "Size must be between 1 and 1MiB"};
+        }
+
+        std::vector<std::byte> mem(size);
+
+        if (!m_process->read(address, mem.data(), size)) {
+            throw RpcServer::Error{RpcServer::internal_error, fmt::format("Failed to read 0x{:X}", address)};
+        }
+
+        std::string hex{};
+
+        for (auto b : mem) {
+            fmt::format_to(std::back_inserter(hex), "{:02X}", (uint8_t)b);
+        }
+
+        return hex;
+    });
+
+    // Reads any number of fields of the chosen type in one batch so a single round trip reads a whole struct.
+    m_rpc.add_method("read_fields", [this](const nlohmann::json& params) -> nlohmann::json {
+        auto struct_ = dynamic_cast<sdkgenny::Struct*>(m_type);
+
+        if (struct_ == nullptr) {
+            throw RpcServer::Error{RpcServer::invalid_params, "No type chosen"};
+        }
+
+        auto address = params.contains("address") ? address_param(params, "address") : m_address;
+        auto paths = params.value("fields", std::vector<std::string>{});
+        std::vector<std::optional<ResolvedField>> fields{};
+        std::vector<std::vector<std::byte>> mems{};
+        std::vector<Process::ReadRequest> requests{};
+
+        fields.reserve(paths.size());
+        mems.reserve(paths.size());
+
+        for (auto&& path : paths) {
+            auto& field = fields.emplace_back(resolve_field(struct_, path));
+
+            if (!field) {
+                continue;
+            }
+
+            auto& mem = mems.emplace_back(field->type->size());
+            requests.emplace_back(Process::ReadRequest{
+                .address = address + field->offset, .buffer = mem.data(), .size = mem.size()});
+        }
+
+        m_process->read_batch(requests);
+
+        nlohmann::json result = nlohmann::json::object();
+        size_t request_index{};
+
+        for (size_t i = 0; i < paths.size(); ++i) {
+            auto& field = fields[i];
+
+            if (!field) {
+                result[paths[i]] = nullptr;
+                continue;
+            }
+
+            auto& request = requests[request_index];
+            auto& mem = mems[request_index++];
+
+            result[paths[i]] = request.ok ? decode_field(*field, mem.data(), mem.size()) : nullptr;
+        }
+
+        return result;
+    });
+
+    m_rpc.add_method("scan_module", [this](const nlohmann::json& params) -> nlohmann::json {
+        if (m_ui.module_scan_in_progress) {
+            throw RpcServer::Error{RpcServer::internal_error, "A module scan is already in progress"};
+        }
+
+        auto module_name = params.value("module", ""s);
+        auto modules = m_process->modules();
+        auto it = std::find_if(
+            modules.begin(), modules.end(), [&](auto&& module) { return module.name.ends_with(module_name); });
+
+        if (module_name.empty() || it == modules.end()) {
+            throw RpcServer::Error{RpcServer::invalid_params, fmt::format("Unknown module '{}'", module_name)};
+        }
+
+        m_ui.selected_module = *it;
+        m_ui.module_scan_search_name = params.value("class_name", ""s);
+        m_ui.module_scan_text.clear();
+        m_ui.module_scan_results.clear();
+        m_ui.module_scan_in_progress = true;
+        m_ui.module_scan_progress = 0.0f;
+
+        std::thread([this]() {
+            scan_module_memory();
+            m_ui.module_scan_in_progress = false;
+        }).detach();
+
+        return true;
+    });
+
+    m_rpc.add_method("scan_results", [this](const nlohmann::json&) -> nlohmann::json {
+        if (m_ui.module_scan_in_progress) {
+            return {{"in_progress", true}, {"progress", m_ui.module_scan_progress}};
+        }
+
+        auto results = nlohmann::json::array();
+
+        for (auto&& result : m_ui.module_scan_results) {
+            results.push_back({{"type", result.type_name}, {"address", result.address}, {"offset", result.offset}});
+        }
+
+        return {{"in_progress", false}, {"results", std::move(results)}};
+    });
+}
+
+void ReGenny::update_rpc_server() {
+    if (m_cfg.rpc_enabled && !m_rpc.is_running()) {
+        // Clients read the token from the config.
+        std::random_device rd{};
+        m_cfg.rpc_token.clear();
+
+        for (auto i = 0; i < 4; ++i) {
+            m_cfg.rpc_token += fmt::format("{:08x}", rd());
+        }
+
+        save_cfg();
+
+        if (!m_rpc.start((uint16_t)m_cfg.rpc_port, m_cfg.rpc_token)) {
+            m_cfg.rpc_enabled = false;
+        }
+    } else if (!m_cfg.rpc_enabled && m_rpc.is_running()) {
+        m_rpc.stop();
+    }
+}
+
+void ReGenny::update_read_limits() {
+    m_process->governor().set_limits({
+        .bytes_per_second = (size_t)m_cfg.read_limit_kib * 1024,
+        .reads_per_second = (size_t)m_cfg.read_limit_reads,
+        .busy_threshold = m_cfg.scan_busy_threshold,
+    });
+}
+
 void ReGenny::set_address() {
     for (auto address : query_address_resolvers(m_ui.address)) {
         auto addr_str = fmt::format("0x{:x}", address);
@@ -1388,12 +2399,25 @@ void ReGenny::set_type() {
     set_address();
 
     m_mem_ui = std::make_unique<MemoryUi>(
-        m_cfg, *m_sdk, dynamic_cast<sdkgenny::Struct*>(m_type), *m_process, m_project.props[m_project.type_chosen]);
+        m_cfg, *m_sdk, dynamic_cast<sdkgenny::Struct*>(m_type), *m_process, type_props(m_project.type_chosen));
+}
+
+sol::state& ReGenny::lua() {
+    std::scoped_lock _{m_lua_lock};
+
+    if (m_lua == nullptr) {
+        reset_lua_state();
+    }
+
+    return *m_lua;
 }
 
 void ReGenny::reset_lua_state() {
     std::scoped_lock _{m_lua_lock};
+    auto start = std::chrono::steady_clock::now();
 
+    // The watch callbacks reference the old state.
+    m_watches.clear();
     m_lua = std::make_unique<sol::state>();
     auto& lua = *m_lua;
 
@@ -1466,6 +2490,101 @@ void ReGenny::reset_lua_state() {
         },
         "remove_address_resolver", [](ReGenny* rg, uint32_t id) {
             rg->remove_address_resolver(id);
+        },
+        "watch", [](sol::this_state s, ReGenny* rg, sol::object address_obj, sol::object type_obj, sol::main_protected_function callback, sol::object opts_obj) -> sol::object {
+            std::optional<ParsedAddress> address{};
+
+            if (address_obj.is<uintptr_t>()) {
+                address = ParsedAddress{.offsets = {address_obj.as<uintptr_t>()}};
+            } else if (address_obj.is<std::string>()) {
+                auto address_str = address_obj.as<std::string>();
+
+                for (auto resolved : rg->query_address_resolvers(address_str)) {
+                    address = ParsedAddress{.offsets = {resolved}};
+                }
+
+                if (auto parsed = parse_address(address_str)) {
+                    address = *parsed;
+                }
+            }
+
+            if (!address) {
+                throw sol::error{"watch: invalid address"};
+            }
+
+            auto kind = WatchList::Kind::Bytes;
+            size_t size{};
+
+            if (type_obj.is<std::string>()) {
+                auto parsed_kind = WatchList::parse_kind(type_obj.as<std::string>());
+
+                if (!parsed_kind) {
+                    throw sol::error{"watch: unknown type " + type_obj.as<std::string>()};
+                }
+
+                kind = *parsed_kind;
+            } else if (type_obj.is<size_t>() && type_obj.as<size_t>() > 0) {
+                size = type_obj.as<size_t>();
+            } else {
+                throw sol::error{"watch: type must be a type name (u32, f32, ...) or a size in bytes"};
+            }
+
+            WatchList::Options options{};
+
+            if (opts_obj.is<sol::table>()) {
+                auto opts = opts_obj.as<sol::table>();
+
+                options.interval = std::chrono::milliseconds{opts.get_or("interval", 100)};
+                options.min_delta = opts.get_or("min_delta", 0.0);
+                options.threshold = opts.get<std::optional<double>>("threshold");
+                options.cooldown = std::chrono::milliseconds{opts.get_or("cooldown", 0)};
+                options.initial = opts.get_or("initial", false);
+            }
+
+            // Callbacks run from update() so use the main thread in case watch was called from a coroutine.
+            sol::this_state main_state{sol::main_thread(s, s)};
+            auto id = rg->watches().add(std::move(*address), kind, size, options, [s = main_state, callback](const WatchList::Watch& watch) {
+                auto to_lua = [&](const std::vector<std::byte>& bytes) -> sol::object {
+                    switch (watch.kind) {
+                    case WatchList::Kind::Bytes:
+                        return sol::make_object(s, std::string{(const char*)bytes.data(), bytes.size()});
+                    case WatchList::Kind::Bool:
+                        return sol::make_object(s, watch.number(bytes) != 0.0);
+                    case WatchList::Kind::F32:
+                    case WatchList::Kind::F64:
+                        return sol::make_object(s, watch.number(bytes));
+                    case WatchList::Kind::U64: {
+                        uint64_t value{};
+                        memcpy(&value, bytes.data(), sizeof(value));
+                        return sol::make_object(s, value);
+                    }
+                    case WatchList::Kind::I64: {
+                        int64_t value{};
+                        memcpy(&value, bytes.data(), sizeof(value));
+                        return sol::make_object(s, value);
+                    }
+                    default:
+                        return sol::make_object(s, (int64_t)watch.number(bytes));
+                    }
+                };
+
+                TRACE_SCOPE("watch_callback", "lua");
+                auto previous = watch.has_reported ? to_lua(watch.reported) : sol::make_object(s, sol::nil);
+                auto result = callback(to_lua(watch.value), previous, watch.id);
+
+                if (!result.valid()) {
+                    sol::error e = result;
+                    throw std::runtime_error{e.what()};
+                }
+
+                // Returning false from the callback removes the watch.
+                return !(result.get_type() == sol::type::boolean && !result.get<bool>());
+            });
+
+            return sol::make_object(s, id);
+        },
+        "unwatch", [](ReGenny* rg, uint32_t id) {
+            return rg->watches().remove(id);
         }
     );
 
@@ -1721,12 +2840,44 @@ void ReGenny::reset_lua_state() {
     };
 
     // clang-format on
+
+    spdlog::info("Created Lua state in {:.1f}ms",
+        std::chrono::duration<double, std::milli>{std::chrono::steady_clock::now() - start}.count());
 }
 
-void ReGenny::parse_file() try {
+void ReGenny::parse_file() {
+    // Let a parse that's still running finish first so its template output gets cleaned up.
+    if (m_parse_future.valid()) {
+        install_parsed_sdk();
+    }
+
     cleanup_template_processing();
 
-    std::optional<preprocessor::PreprocessResult> template_result{};
+    m_parse_future = std::async(std::launch::async, [path = m_open_filepath, &preprocessor = m_template_preprocessor] {
+        return parse_sdk(path, preprocessor);
+    });
+}
+
+std::filesystem::path ReGenny::original_path(const std::filesystem::path& import) const {
+    if (!m_template_processing) {
+        return import;
+    }
+
+    auto& processed_to_original = m_template_processing->m_processed_to_original;
+    auto lookup = processed_to_original.find(import);
+
+    if (lookup == processed_to_original.end()) {
+        lookup = processed_to_original.find(import.lexically_normal());
+    }
+
+    return lookup != processed_to_original.end() ? lookup->second : import;
+}
+
+ReGenny::ParsedSdk ReGenny::parse_sdk(
+    const std::filesystem::path& filepath, preprocessor::IPreprocessor& preprocessor) {
+    TRACE_SCOPE("parse_sdk", "parse");
+    auto start = std::chrono::steady_clock::now();
+    ParsedSdk parsed{};
     struct TemplateCleanupGuard {
         std::optional<preprocessor::PreprocessResult>* result{};
         preprocessor::IPreprocessor* preprocessor{};
@@ -1737,101 +2888,123 @@ void ReGenny::parse_file() try {
                 preprocessor->cleanup(result->value());
             }
         }
-    } 
-    
-    cleanup_guard{&template_result, &m_template_preprocessor, false};
-    auto parse_path = m_open_filepath;
+    } cleanup_guard{&parsed.template_processing, &preprocessor, false};
+    auto parse_path = filepath;
 
-    if (auto processed = m_template_preprocessor.process_tree(m_open_filepath); processed) {
-        template_result = std::move(processed);
-        parse_path = template_result->m_processed_root;
-    }
+    {
+        TRACE_SCOPE("preprocess", "parse");
 
-    m_file_lwt = {};
+        if (auto processed = preprocessor.process_tree(filepath); processed) {
+            parsed.template_processing = std::move(processed);
+            parse_path = parsed.template_processing->m_processed_root;
+        }
+    }
 
     auto sdk = std::make_unique<sdkgenny::Sdk>();
 
     sdk->import(parse_path);
 
-    sdkgenny::parser::State s{};
-    s.filepath = parse_path;
-    s.parents.push_back(sdk->global_ns());
+    {
+        TRACE_SCOPE("grammar", "parse");
+        sdkgenny::parser::State s{};
+        s.filepath = parse_path;
+        s.parents.push_back(sdk->global_ns());
 
-    tao::pegtl::file_input in{parse_path};
+        tao::pegtl::file_input in{parse_path};
 
-    if (tao::pegtl::parse<sdkgenny::parser::Grammar, sdkgenny::parser::Action>(in, s)) {
-        // We just parsed, so record the max last write time for any of the imported files.
-        // This prevents reloading on opening a file for the first time since launch.
-        auto record_last_write_time = [this](const std::filesystem::path& path) {
-            std::error_code ec{};
-            auto lwt = std::filesystem::last_write_time(path, ec);
+        if (!tao::pegtl::parse<sdkgenny::parser::Grammar, sdkgenny::parser::Action>(in, s)) {
+            throw std::runtime_error{"Failed to parse file."};
+        }
+    }
 
-            if (!ec) {
-                m_file_lwt = std::max(m_file_lwt, lwt);
-            }
-        };
+    // We just parsed, so record the max last write time for any of the imported files.
+    // This prevents reloading on opening a file for the first time since launch.
+    auto record_last_write_time = [&parsed](const std::filesystem::path& path) {
+        std::error_code ec{};
+        auto lwt = std::filesystem::last_write_time(path, ec);
 
-        record_last_write_time(m_open_filepath);
+        if (!ec) {
+            parsed.lwt = std::max(parsed.lwt, lwt);
+        }
+    };
 
-        for (auto&& import : sdk->imports()) {
-            std::filesystem::path original_path = import;
+    record_last_write_time(filepath);
 
-            if (template_result) {
-                auto lookup = template_result->m_processed_to_original.find(import);
+    for (auto&& import : sdk->imports()) {
+        std::filesystem::path original_path = import;
 
-                if (lookup == template_result->m_processed_to_original.end()) {
-                    lookup = template_result->m_processed_to_original.find(import.lexically_normal());
-                }
+        if (parsed.template_processing) {
+            auto& processed_to_original = parsed.template_processing->m_processed_to_original;
+            auto lookup = processed_to_original.find(import);
 
-                if (lookup != template_result->m_processed_to_original.end()) {
-                    original_path = lookup->second;
-                }
+            if (lookup == processed_to_original.end()) {
+                lookup = processed_to_original.find(import.lexically_normal());
             }
 
-            record_last_write_time(original_path);
+            if (lookup != processed_to_original.end()) {
+                original_path = lookup->second;
+            }
         }
 
-        m_sdk = std::move(sdk);
-        m_template_processing = std::move(template_result);
-        cleanup_guard.keep = m_template_processing.has_value();
+        record_last_write_time(original_path);
+    }
 
-        if (m_mem_ui != nullptr) {
-            m_project.props[m_project.type_chosen] = m_mem_ui->props();
-            m_mem_ui.reset();
-        }
+    parsed.sdk = std::move(sdk);
+    cleanup_guard.keep = true;
 
-        // Build the list of selectable types for the type selector.
-        m_ui.type_names.clear();
+    spdlog::info("Parsed {} in {:.1f}ms", filepath.string(),
+        std::chrono::duration<double, std::milli>{std::chrono::steady_clock::now() - start}.count());
 
-        std::unordered_set<sdkgenny::Struct*> structs{};
-        m_sdk->global_ns()->get_all_in_children<sdkgenny::Struct>(structs);
+    return parsed;
+}
 
-        for (auto&& struct_ : structs) {
-            std::vector<std::string> parent_names{};
+void ReGenny::install_parsed_sdk() try {
+    auto parsed = m_parse_future.get();
 
-            for (auto p = struct_->owner<sdkgenny::Object>(); p != nullptr && !p->is_a<sdkgenny::Sdk>();
-                 p = p->owner<sdkgenny::Object>()) {
-                if (auto& name = p->name(); !name.empty()) {
-                    parent_names.emplace_back(name);
-                }
-            }
+    // A capture that's running walks the types of the sdk about to be replaced.
+    cancel_snapshot_capture();
+
+    // The memory view's nodes point into the old sdk and the caches, so it goes before either of them.
+    if (m_mem_ui != nullptr) {
+        m_project.props[m_project.type_chosen] = m_mem_ui->props();
+        m_mem_ui.reset();
+    }
+
+    m_file_lwt = parsed.lwt;
+    m_sdk = std::move(parsed.sdk);
+    node::Pointer::clear_rtti_cache();
+    node::LayoutCache::clear();
+    m_template_processing = std::move(parsed.template_processing);
+
+    // Build the list of selectable types for the type selector.
+    m_ui.type_names.clear();
+
+    std::unordered_set<sdkgenny::Struct*> structs{};
+    m_sdk->global_ns()->get_all_in_children<sdkgenny::Struct>(structs);
 
-            std::reverse(parent_names.begin(), parent_names.end());
-            std::string name{};
+    for (auto&& struct_ : structs) {
+        std::vector<std::string> parent_names{};
 
-            for (auto p : parent_names) {
-                name += p + '.';
+        for (auto p = struct_->owner<sdkgenny::Object>(); p != nullptr && !p->is_a<sdkgenny::Sdk>();
+             p = p->owner<sdkgenny::Object>()) {
+            if (auto& name = p->name(); !name.empty()) {
+                parent_names.emplace_back(name);
             }
+        }
 
-            name += struct_->name();
+        std::reverse(parent_names.begin(), parent_names.end());
+        std::string name{};
 
-            m_ui.type_names.emplace(std::move(name));
+        for (auto p : parent_names) {
+            name += p + '.';
         }
 
-        set_type();
-    } else {
-        throw std::runtime_error{"Failed to parse file."};
+        name += struct_->name();
+
+        m_ui.type_names.emplace(std::move(name));
     }
+
+    set_type();
 } catch (const std::exception& e) {
     spdlog::error(e.what());
 }
@@ -1911,6 +3084,8 @@ void ReGenny::set_window_title() {
 
     if (m_process && m_process->process_id() != 0 && !m_project.process_name.empty()) {
         title += fmt::format(" - {} PID: {}", m_project.process_name, m_project.process_id);
+    } else if (dynamic_cast<SnapshotProcess*>(m_process.get()) != nullptr) {
+        title += " - Snapshot";
     }
 
     SDL_SetWindowTitle(m_window, title.c_str());
@@ -3,9 +3,11 @@
 #include <chrono>
 #include <deque>
 #include <filesystem>
+#include <future>
 #include <map>
 #include <memory>
 #include <optional>
+#include <set>
 #include <string>
 #include <unordered_map>
 
@@ -13,13 +15,20 @@
 #include <sdkgenny.hpp>
 #include <sol/sol.hpp>
 
+#include "CompareUi.hpp"
 #include "Config.hpp"
 #include "Helpers.hpp"
+#include "LayoutUi.hpp"
 #include "LoggerUi.hpp"
+#include "MemoryAccountant.hpp"
 #include "MemoryUi.hpp"
 #include "Process.hpp"
 #include "Project.hpp"
+#include "RpcServer.hpp"
+#include "RttiExportUi.hpp"
+#include "TypeSearchUi.hpp"
 #include "Utility.hpp"
+#include "WatchList.hpp"
 #include "node/Property.hpp"
 #include "preprocessors/TemplatePreprocessor.hpp"
 #include "sdl_trigger.h"
@@ -45,6 +54,7 @@ public:
     auto type() const { return m_type; }
     auto& process() const { return m_process; }
     auto address() const { return m_address; }
+    auto& watches() { return m_watches; }
 
     auto add_address_resolver(std::function<uintptr_t(const std::string&)> resolver) {
         auto id = m_address_resolvers.size();
@@ -105,6 +115,11 @@ private:
         ImGuiID about_popup{};
         ImGuiID extensions_popup{};
         ImGuiID module_memory_scan_popup{};
+        ImGuiID compare_popup{};
+        ImGuiID layout_popup{};
+        ImGuiID type_search_popup{};
+        ImGuiID rtti_export_popup{};
+        ImGuiID snapshot_popup{};
 
         // Module memory scanning
         Process::Module selected_module{};
@@ -113,9 +128,24 @@ private:
         bool module_scan_in_progress{false};
         float module_scan_progress{0.0f};
         std::vector<ModuleScanResult> module_scan_results{};
+
+        // Memory usage
+        std::optional<uint32_t> memory_load{};
+        std::optional<size_t> working_set{};
+        bool memory_warned{};
     } m_ui{};
 
     std::unique_ptr<MemoryUi> m_mem_ui{};
+    CompareUi m_compare_ui{};
+    LayoutUi m_layout_ui{};
+    TypeSearchUi m_type_search_ui{};
+    RttiExportUi m_rtti_export_ui{};
+
+    // Capture Snapshot runs in the background and writes the bundle once it's done (see save_bundle).
+    std::future<void> m_snapshot_capture{};
+    std::atomic<bool> m_snapshot_cancel{};
+    std::atomic<float> m_snapshot_progress{};
+    RpcServer m_rpc{};
 
     std::filesystem::path m_open_filepath{};
     std::filesystem::file_time_type m_file_lwt;
@@ -130,17 +160,39 @@ private:
 
     Config m_cfg{};
     std::optional<std::chrono::system_clock::time_point> m_cfg_save_time{};
+
+    MemoryAccountant::Usage m_props_usage{MemoryAccountant::Category::Props};
+    std::chrono::steady_clock::time_point m_next_memory_check_time{};
     std::optional<preprocessor::PreprocessResult> m_template_processing{};
+
+    struct ParsedSdk {
+        std::unique_ptr<sdkgenny::Sdk> sdk{};
+        std::optional<preprocessor::PreprocessResult> template_processing{};
+        // Max last write time of the file and everything it imports.
+        std::filesystem::file_time_type lwt{};
+    };
+
+    // Files are parsed in the background and installed from update() once they're done.
+    std::future<ParsedSdk> m_parse_future{};
     
     preprocessor::TemplatePreprocessor m_template_preprocessor{};
 
+    // Only set until the first frame has been presented so we can log how long startup took.
+    std::optional<std::chrono::steady_clock::time_point> m_startup_time{};
+
     std::recursive_mutex m_lua_lock{};
     std::unique_ptr<sol::state> m_lua{};
+    // Declared after m_lua so the Lua callbacks are destroyed before the state they belong to.
+    WatchList m_watches{};
     std::deque<std::string> m_eval_history{};
     int32_t m_eval_history_index{};
     bool m_reapply_focus_eval{false};
 
     Project m_project{};
+    ProjectWriter m_project_writer{};
+    std::optional<std::chrono::system_clock::time_point> m_project_save_time{};
+    // Hash of the props last loaded or saved for each type, so saving only writes the types that changed.
+    std::unordered_map<std::string, size_t> m_saved_props{};
 
     void menu_ui();
 
@@ -150,6 +202,8 @@ private:
     void load_project();
     void file_save();
     void save_project();
+    // The props of type_name, loaded from the project's props directory the first time they're needed.
+    node::Property& type_props(const std::string& type_name);
     void file_save_as();
     void file_open_in_editor();
     void file_quit();
@@ -157,21 +211,40 @@ private:
 
     void action_detach();
     void action_generate_sdk();
+    void action_capture_snapshot();
+    void save_bundle(sdkgenny::Struct* struct_, uintptr_t address, int depth, std::filesystem::path bundle_filepath,
+        std::filesystem::path root_dir, std::set<std::filesystem::path> sources, Project project);
+    // Stops a capture that's running and waits for it (call before the process or the sdk goes away).
+    void cancel_snapshot_capture();
+    void open_snapshot(const std::filesystem::path& path);
 
     void attach_ui();
     void attach();
 
     void rtti_ui();
+    void snapshot_ui();
     void rtti_sweep_ui();
     void module_memory_scan_ui();
     void scan_module_memory();
 
     void update_address();
     void memory_ui();
+    void update_memory_usage();
+    void memory_usage_ui();
+    void register_rpc_methods();
+    void update_rpc_server();
+    void update_read_limits();
     void set_address();
     void set_type();
 
     void parse_file();
+    // The file an import of the parsed sdk came from (imports can be the template preprocessor's output).
+    std::filesystem::path original_path(const std::filesystem::path& import) const;
+    static ParsedSdk parse_sdk(const std::filesystem::path& filepath, preprocessor::IPreprocessor& preprocessor);
+    void install_parsed_sdk();
+
+    // The Lua state is created on first use since it's the most expensive part of startup.
+    sol::state& lua();
     void reset_lua_state();
 
     void load_cfg();
@@ -0,0 +1,135 @@
+#include <algorithm>
+#include <thread>
+
+#include "ReadGovernor.hpp"
+
+using namespace std::literals;
+
+namespace {
+// Fraction of each bucket scans leave for interactive and watch reads.
+constexpr auto scan_reserve = 0.25;
+constexpr auto busy_sample_interval = 250ms;
+constexpr auto wait_step = 5ms;
+
+thread_local ReadGovernor::Priority t_priority{ReadGovernor::Priority::Interactive};
+thread_local const std::atomic<bool>* t_cancel{};
+} // namespace
+
+ReadGovernor::PriorityScope::PriorityScope(Priority priority, const std::atomic<bool>* cancel)
+    : m_previous{t_priority}, m_previous_cancel{t_cancel} {
+    t_priority = priority;
+    t_cancel = cancel;
+}
+
+ReadGovernor::PriorityScope::~PriorityScope() {
+    t_priority = m_previous;
+    t_cancel = m_previous_cancel;
+}
+
+ReadGovernor::Priority ReadGovernor::priority() {
+    return t_priority;
+}
+
+void ReadGovernor::set_limits(const Limits& limits) {
+    std::scoped_lock _{m_lock};
+
+    m_limits = limits;
+    m_bytes.rate = (double)limits.bytes_per_second;
+    m_reads.rate = (double)limits.reads_per_second;
+
+    if (limits.busy_threshold <= 0) {
+        m_busy = false;
+        m_last_cpu_time = std::nullopt;
+    }
+}
+
+bool ReadGovernor::acquire(size_t bytes) {
+    auto throttled = false;
+
+    while (!try_acquire(bytes)) {
+        if (t_cancel != nullptr && *t_cancel) {
+            return false;
+        }
+
+        if (!throttled) {
+            throttled = true;
+            ++m_num_throttled;
+        }
+
+        std::this_thread::sleep_for(wait_step);
+    }
+
+    return true;
+}
+
+bool ReadGovernor::try_acquire(size_t bytes) {
+    std::scoped_lock _{m_lock};
+
+    if (!can_read(t_priority, std::chrono::steady_clock::now())) {
+        return false;
+    }
+
+    m_bytes.take((double)bytes);
+    m_reads.take(1.0);
+    return true;
+}
+
+void ReadGovernor::Bucket::refill(double seconds) {
+    // A bucket holds at most a second's worth of tokens.
+    tokens = std::min(rate, tokens + rate * seconds);
+}
+
+void ReadGovernor::Bucket::take(double amount) {
+    // Going into debt is fine, it's paid back before anyone below interactive gets to read again.
+    if (rate != 0.0) {
+        tokens -= amount;
+    }
+}
+
+bool ReadGovernor::can_read(Priority priority, std::chrono::steady_clock::time_point now) {
+    m_bytes.refill(std::chrono::duration<double>(now - m_last_refill).count());
+    m_reads.refill(std::chrono::duration<double>(now - m_last_refill).count());
+    m_last_refill = now;
+
+    if (priority == Priority::Interactive) {
+        return true;
+    }
+
+    if (priority == Priority::Watch) {
+        return m_bytes.has(0.0) && m_reads.has(0.0);
+    }
+
+    if (m_limits.busy_threshold > 0) {
+        sample_busy(now);
+
+        if (m_busy) {
+            return false;
+        }
+    }
+
+    return m_bytes.has(m_bytes.rate * scan_reserve) && m_reads.has(m_reads.rate * scan_reserve);
+}
+
+void ReadGovernor::sample_busy(std::chrono::steady_clock::time_point now) {
+    if (m_last_cpu_time && now - m_last_cpu_sample < busy_sample_interval) {
+        return;
+    }
+
+    auto cpu_time = m_cpu_time ? m_cpu_time() : std::nullopt;
+
+    if (!cpu_time) {
+        m_busy = false;
+        return;
+    }
+
+    if (m_last_cpu_time) {
+        auto wall = std::chrono::duration<double>(now - m_last_cpu_sample).count();
+        auto cpu = std::chrono::duration<double>(*cpu_time - *m_last_cpu_time).count();
+        auto cores = std::max(std::thread::hardware_concurrency(), 1u);
+
+        m_busy = cpu / (wall * cores) * 100.0 >= m_limits.busy_threshold;
+    }
+
+    m_last_cpu_time = cpu_time;
+    m_last_cpu_sample = now;
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <optional>
+
+// Limits how hard we hit the target. Every read that actually reaches the process (cache hits don't count) is charged
+// to a bytes per second and a reads per second token bucket. Interactive reads never wait so the UI stays responsive
+// however low the caps are set, but they still drain the buckets. Watch lists wait until the buckets are back above
+// zero, and scans also leave a reserve of each bucket for everyone else and pause while the target is busy.
+class ReadGovernor {
+public:
+    // Highest first. Reads are charged to the priority of the thread that makes them.
+    enum class Priority {
+        Interactive,
+        Watch,
+        Scan,
+    };
+
+    struct Limits {
+        // 0 is unlimited.
+        size_t bytes_per_second{};
+        size_t reads_per_second{};
+        // Target CPU usage (percent of all cores) at which scans pause. 0 never pauses.
+        int busy_threshold{};
+    };
+
+    // Sets the priority of the reads made by the current thread for its lifetime. A scan waiting on the governor gives
+    // up (the read fails) once cancel is set, so a cancel that's already set means reads never wait.
+    class PriorityScope {
+    public:
+        PriorityScope(Priority priority, const std::atomic<bool>* cancel = nullptr);
+        ~PriorityScope();
+
+        PriorityScope(const PriorityScope&) = delete;
+        PriorityScope& operator=(const PriorityScope&) = delete;
+
+    private:
+        Priority m_previous{};
+        const std::atomic<bool>* m_previous_cancel{};
+    };
+
+    using CpuTimeFn = std::function<std::optional<std::chrono::nanoseconds>()>;
+
+    // cpu_time returns the total CPU time used by the target so far. It's only used for the busy heuristic.
+    explicit ReadGovernor(CpuTimeFn cpu_time) : m_cpu_time{std::move(cpu_time)} {}
+
+    static Priority priority();
+
+    void set_limits(const Limits& limits);
+
+    // Charges a read of bytes to the calling thread's priority, waiting if it has to. Returns false if the read was
+    // canceled while waiting.
+    bool acquire(size_t bytes);
+    // Charges a read of bytes only if it can go ahead right now.
+    bool try_acquire(size_t bytes);
+
+    bool is_target_busy() const { return m_busy; }
+    // Reads that had to wait so far.
+    size_t num_throttled() const { return m_num_throttled; }
+
+private:
+    struct Bucket {
+        double rate{};
+        double tokens{};
+
+        void refill(double seconds);
+        bool has(double floor) const { return rate == 0.0 || tokens > floor; }
+        void take(double amount);
+    };
+
+    CpuTimeFn m_cpu_time{};
+
+    std::mutex m_lock{};
+    Limits m_limits{};
+    Bucket m_bytes{};
+    Bucket m_reads{};
+    std::chrono::steady_clock::time_point m_last_refill{std::chrono::steady_clock::now()};
+
+    std::optional<std::chrono::nanoseconds> m_last_cpu_time{};
+    std::chrono::steady_clock::time_point m_last_cpu_sample{};
+    std::atomic<bool> m_busy{};
+    std::atomic<size_t> m_num_throttled{};
+
+    bool can_read(Priority priority, std::chrono::steady_clock::time_point now);
+    void sample_busy(std::chrono::steady_clock::time_point now);
+};
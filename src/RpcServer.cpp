@@ -0,0 +1,364 @@
+// Winsock has to be included before Windows.h.
+#include <WinSock2.h>
+#include <WS2tcpip.h>
+
+#include <algorithm>
+#include <array>
+#include <iterator>
+#include <utility>
+
+#include <spdlog/spdlog.h>
+
+#include "scope_guard.hpp"
+
+#include "RpcServer.hpp"
+
+// Strings read out of the process can be invalid UTF-8, which dump() would otherwise throw on.
+static std::string dump(const nlohmann::json& j) {
+    return j.dump(-1, ' ', false, nlohmann::json::error_handler_t::replace);
+}
+
+// eg. "POST / HTTP/1.1".
+static bool is_http_request_line(const std::string& line) {
+    auto method_end = line.find(' ');
+
+    if (method_end == std::string::npos || method_end == 0 ||
+        !std::all_of(line.begin(), line.begin() + method_end, [](char c) { return c >= 'A' && c <= 'Z'; })) {
+        return false;
+    }
+
+    return line.find(" HTTP/", method_end) != std::string::npos;
+}
+
+RpcServer::~RpcServer() {
+    stop();
+}
+
+bool RpcServer::start(uint16_t port, std::string token) {
+    stop();
+
+    m_token = std::move(token);
+
+    WSADATA wsa_data{};
+
+    if (WSAStartup(MAKEWORD(2, 2), &wsa_data) != 0) {
+        spdlog::error("RPC: WSAStartup failed");
+        return false;
+    }
+
+    m_is_wsa_started = true;
+
+    auto listen_socket = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+
+    if (listen_socket == INVALID_SOCKET) {
+        spdlog::error("RPC: Failed to create socket ({})", WSAGetLastError());
+        stop();
+        return false;
+    }
+
+    // Only ever listen on the loopback interface.
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+
+    if (bind(listen_socket, (sockaddr*)&addr, sizeof(addr)) == SOCKET_ERROR ||
+        listen(listen_socket, SOMAXCONN) == SOCKET_ERROR) {
+        spdlog::error("RPC: Failed to listen on 127.0.0.1:{} ({})", port, WSAGetLastError());
+        closesocket(listen_socket);
+        stop();
+        return false;
+    }
+
+    m_listen_socket = (uintptr_t)listen_socket;
+    m_is_running = true;
+    m_listen_thread = std::thread{[this] { listen_loop(); }};
+
+    spdlog::info("RPC: Listening on 127.0.0.1:{}", port);
+
+    return true;
+}
+
+void RpcServer::stop() {
+    auto was_running = m_is_running.exchange(false);
+
+    if (was_running) {
+        // Closing the listen socket makes accept() fail which ends the listen loop.
+        closesocket((SOCKET)m_listen_socket);
+        m_listen_socket = 0;
+
+        if (m_listen_thread.joinable()) {
+            m_listen_thread.join();
+        }
+
+        std::vector<std::unique_ptr<Connection>> connections{};
+
+        {
+            std::scoped_lock _{m_connections_lock};
+
+            for (auto&& connection : m_connections) {
+                if (!connection->is_closed) {
+                    shutdown((SOCKET)connection->socket, SD_BOTH);
+                    closesocket((SOCKET)connection->socket);
+                    connection->is_closed = true;
+                }
+            }
+
+            connections = std::move(m_connections);
+            m_connections.clear();
+        }
+
+        // Connection threads may be waiting on a response that will now never be executed.
+        {
+            std::scoped_lock _{m_requests_lock};
+
+            for (auto&& request : m_requests) {
+                request.response.set_value({});
+            }
+
+            m_requests.clear();
+        }
+
+        for (auto&& connection : connections) {
+            if (connection->thread.joinable()) {
+                connection->thread.join();
+            }
+        }
+
+        spdlog::info("RPC: Stopped");
+    }
+
+    if (m_is_wsa_started) {
+        WSACleanup();
+        m_is_wsa_started = false;
+    }
+}
+
+void RpcServer::process_requests() {
+    std::vector<PendingRequest> requests{};
+
+    {
+        std::scoped_lock _{m_requests_lock};
+        requests = std::move(m_requests);
+        m_requests.clear();
+    }
+
+    for (auto&& request : requests) {
+        request.response.set_value(handle_message(request.message));
+    }
+}
+
+void RpcServer::listen_loop() {
+    while (m_is_running) {
+        auto client = accept((SOCKET)m_listen_socket, nullptr, nullptr);
+
+        if (client == INVALID_SOCKET) {
+            break;
+        }
+
+        // Scripts that reconnect a lot would otherwise leave a finished thread behind for every connection.
+        reap_connections();
+
+        std::scoped_lock _{m_connections_lock};
+
+        if (!m_is_running) {
+            closesocket(client);
+            break;
+        }
+
+        auto& connection = *m_connections.emplace_back(std::make_unique<Connection>());
+
+        connection.socket = (uintptr_t)client;
+        connection.thread = std::thread{[this, &connection] { connection_loop(connection); }};
+    }
+}
+
+void RpcServer::reap_connections() {
+    std::vector<std::unique_ptr<Connection>> done{};
+
+    {
+        std::scoped_lock _{m_connections_lock};
+
+        auto it = std::stable_partition(m_connections.begin(), m_connections.end(),
+            [](auto&& connection) { return !connection->is_done.load(); });
+
+        std::move(it, m_connections.end(), std::back_inserter(done));
+        m_connections.erase(it, m_connections.end());
+    }
+
+    for (auto&& connection : done) {
+        connection->thread.join();
+    }
+}
+
+void RpcServer::connection_loop(Connection& connection) {
+    auto socket = connection.socket;
+    // Declared first so it runs last.
+    auto done = sg::make_scope_guard([&connection] { connection.is_done = true; });
+    auto cleanup = sg::make_scope_guard([this, &connection] {
+        std::scoped_lock _{m_connections_lock};
+
+        // stop() closes the sockets of the connections that are still open itself.
+        if (!connection.is_closed) {
+            closesocket((SOCKET)connection.socket);
+            connection.is_closed = true;
+        }
+    });
+
+    std::string buffer{};
+    std::array<char, 4096> chunk{};
+    auto is_first_line = true;
+
+    while (m_is_running) {
+        auto received = recv((SOCKET)socket, chunk.data(), (int)chunk.size(), 0);
+
+        if (received <= 0) {
+            break;
+        }
+
+        buffer.append(chunk.data(), received);
+
+        if (buffer.size() > max_message_size && buffer.find('\n') == std::string::npos) {
+            spdlog::warn("RPC: Dropping a connection that sent {} bytes without a newline", buffer.size());
+            return;
+        }
+
+        // Every complete line is a message.
+        for (auto pos = buffer.find('\n'); pos != std::string::npos; pos = buffer.find('\n')) {
+            auto message = buffer.substr(0, pos);
+            buffer.erase(0, pos + 1);
+
+            if (message.find_first_not_of(" \t\r") == std::string::npos) {
+                continue;
+            }
+
+            // A browser's request body would otherwise get here after its headers failed to parse.
+            if (std::exchange(is_first_line, false) && is_http_request_line(message)) {
+                spdlog::warn("RPC: Dropping a connection that sent an HTTP request");
+                return;
+            }
+
+            std::future<std::string> response{};
+
+            {
+                std::scoped_lock _{m_requests_lock};
+
+                if (!m_is_running) {
+                    return;
+                }
+
+                auto& request = m_requests.emplace_back();
+                request.message = std::move(message);
+                response = request.response.get_future();
+            }
+
+            auto response_str = response.get();
+
+            // Notifications (and requests dropped by stop()) don't get a response.
+            if (response_str.empty()) {
+                continue;
+            }
+
+            response_str += '\n';
+
+            for (size_t sent = 0; sent < response_str.size();) {
+                auto result = send((SOCKET)socket, response_str.data() + sent, (int)(response_str.size() - sent), 0);
+
+                if (result == SOCKET_ERROR) {
+                    return;
+                }
+
+                sent += result;
+            }
+        }
+    }
+}
+
+std::string RpcServer::handle_message(const std::string& message) {
+    auto make_error = [](int code, const std::string& msg) {
+        return nlohmann::json{{"jsonrpc", "2.0"}, {"error", {{"code", code}, {"message", msg}}}, {"id", nullptr}};
+    };
+
+    nlohmann::json j{};
+
+    try {
+        j = nlohmann::json::parse(message);
+    } catch (const nlohmann::json::exception& e) {
+        return dump(make_error(parse_error, e.what()));
+    }
+
+    // Anything unexpected (eg. a field of the wrong type) is reported back rather than taking down the UI thread.
+    auto handle = [&](const nlohmann::json& request) -> std::optional<nlohmann::json> {
+        try {
+            return handle_request(request);
+        } catch (const std::exception& e) {
+            return make_error(internal_error, e.what());
+        }
+    };
+
+    if (j.is_array()) {
+        if (j.empty()) {
+            return dump(make_error(invalid_request, "Empty batch"));
+        }
+
+        auto responses = nlohmann::json::array();
+
+        for (auto&& request : j) {
+            if (auto response = handle(request)) {
+                responses.emplace_back(std::move(*response));
+            }
+        }
+
+        return responses.empty() ? std::string{} : dump(responses);
+    }
+
+    if (auto response = handle(j)) {
+        return dump(*response);
+    }
+
+    return {};
+}
+
+std::optional<nlohmann::json> RpcServer::handle_request(const nlohmann::json& request) {
+    auto make_error = [](const nlohmann::json& id, int code, const std::string& msg) {
+        return nlohmann::json{{"jsonrpc", "2.0"}, {"error", {{"code", code}, {"message", msg}}}, {"id", id}};
+    };
+
+    if (!request.is_object() || !request.contains("jsonrpc") || !request["jsonrpc"].is_string() ||
+        request["jsonrpc"] != "2.0" || !request.contains("method") || !request["method"].is_string()) {
+        return make_error(nullptr, invalid_request, "Invalid request");
+    }
+
+    auto is_notification = !request.contains("id");
+    auto id = request.value("id", nlohmann::json{});
+
+    if (!request.contains("token") || !request["token"].is_string() || request["token"] != m_token) {
+        return is_notification ? std::nullopt : std::optional{make_error(id, unauthorized, "Missing or wrong token")};
+    }
+    auto method_name = request["method"].get<std::string>();
+    auto method = m_methods.find(method_name);
+
+    if (method == m_methods.end()) {
+        if (is_notification) {
+            return std::nullopt;
+        }
+
+        return make_error(id, method_not_found, "Method not found: " + method_name);
+    }
+
+    nlohmann::json result{};
+
+    try {
+        result = method->second(request.value("params", nlohmann::json::object()));
+    } catch (const Error& e) {
+        return is_notification ? std::nullopt : std::optional{make_error(id, e.code(), e.what())};
+    } catch (const std::exception& e) {
+        return is_notification ? std::nullopt : std::optional{make_error(id, internal_error, e.what())};
+    }
+
+    if (is_notification) {
+        return std::nullopt;
+    }
+
+    return nlohmann::json{{"jsonrpc", "2.0"}, {"result", std::move(result)}, {"id", id}};
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+// Opt-in JSON-RPC 2.0 server listening on localhost so scripts and other tools can drive a running ReGenny. Messages
+// are newline delimited and may be batches (arrays of requests). Connections are serviced on their own threads but
+// every method is executed on the UI thread from process_requests() so methods can safely touch ReGenny's state.
+//
+// Every request has to carry the token the server was started with as a "token" member next to "method", so only
+// something that can read our config can use it. Connections that start like an HTTP request (eg. a web page POSTing
+// to localhost) are dropped before anything they send is run.
+class RpcServer {
+public:
+    using Method = std::function<nlohmann::json(const nlohmann::json& params)>;
+
+    // Throw from a method to respond with a specific JSON-RPC error.
+    class Error : public std::runtime_error {
+    public:
+        Error(int code, const std::string& message) : std::runtime_error{message}, m_code{code} {}
+
+        auto code() const { return m_code; }
+
+    private:
+        int m_code{};
+    };
+
+    static constexpr int parse_error = -32700;
+    static constexpr int invalid_request = -32600;
+    static constexpr int method_not_found = -32601;
+    static constexpr int invalid_params = -32602;
+    static constexpr int internal_error = -32603;
+    static constexpr int unauthorized = -32001;
+
+    RpcServer() = default;
+    RpcServer(const RpcServer&) = delete;
+    RpcServer& operator=(const RpcServer&) = delete;
+    ~RpcServer();
+
+    bool start(uint16_t port, std::string token);
+    void stop();
+    auto is_running() const { return m_is_running.load(); }
+
+    void add_method(const std::string& name, Method method) { m_methods[name] = std::move(method); }
+
+    // Executes every request received since the last call.
+    void process_requests();
+
+private:
+    // A connection that goes this long without a newline is dropped.
+    static constexpr size_t max_message_size = 16 * 1024 * 1024;
+
+    struct Connection {
+        uintptr_t socket{};
+        // Guarded by m_connections_lock.
+        bool is_closed{};
+        std::thread thread{};
+        // Set as the very last thing the connection's thread does, so joining it can't block.
+        std::atomic<bool> is_done{};
+    };
+
+    struct PendingRequest {
+        std::string message{};
+        std::promise<std::string> response{};
+    };
+
+    std::unordered_map<std::string, Method> m_methods{};
+
+    std::string m_token{};
+    std::atomic<bool> m_is_running{};
+    bool m_is_wsa_started{};
+    uintptr_t m_listen_socket{};
+    std::thread m_listen_thread{};
+
+    std::mutex m_connections_lock{};
+    std::vector<std::unique_ptr<Connection>> m_connections{};
+
+    std::mutex m_requests_lock{};
+    std::vector<PendingRequest> m_requests{};
+
+    void listen_loop();
+    void connection_loop(Connection& connection);
+    // Joins the threads of connections that have ended.
+    void reap_connections();
+
+    std::string handle_message(const std::string& message);
+    std::optional<nlohmann::json> handle_request(const nlohmann::json& request);
+};
@@ -0,0 +1,571 @@
+#include <algorithm>
+#include <fstream>
+#include <functional>
+#include <mutex>
+#include <sstream>
+#include <unordered_set>
+
+#include <fmt/format.h>
+#include <imgui.h>
+#include <imgui_stdlib.h>
+#include <nfd.h>
+#include <ppl.h>
+#include <spdlog/spdlog.h>
+
+#include "Utility.hpp"
+
+#include "RttiExportUi.hpp"
+
+using namespace std::literals;
+
+// Memory is searched for instances in chunks of this size.
+static constexpr size_t chunk_size = 1024 * 1024;
+// Distances between instances larger than this aren't considered when estimating sizes.
+static constexpr size_t max_inferred_size = 0x10000;
+
+static uint32_t fnv1a(std::string_view s) {
+    uint32_t hash = 0x811C9DC5;
+
+    for (auto c : s) {
+        hash = (hash ^ (uint8_t)c) * 0x01000193;
+    }
+
+    return hash;
+}
+
+// The body of the block for a class (everything between the rtti comments).
+static std::string class_block(const std::string& genny_name, const Process::RttiClass* c,
+    const std::unordered_map<std::string, std::string>& genny_names, std::optional<size_t> size) {
+    std::vector<std::string> scopes{};
+
+    for (size_t start = 0, end = 0; end != std::string::npos; start = end + 1) {
+        end = genny_name.find('.', start);
+        scopes.emplace_back(genny_name.substr(start, end - start));
+    }
+
+    auto& struct_name = scopes.back();
+    std::string indent{};
+    std::string out{};
+
+    for (size_t i = 0; i + 1 < scopes.size(); ++i) {
+        out += fmt::format("{}namespace {} {{\n", indent, scopes[i]);
+        indent += "    ";
+    }
+
+    if (c != nullptr && c->num_vfuncs > 0) {
+        out += fmt::format("{}struct {}_vtbl 0x{:X} {{}}\n", indent, struct_name, c->num_vfuncs * sizeof(uintptr_t));
+    }
+
+    out += fmt::format("{}struct {}", indent, struct_name);
+
+    if (c != nullptr && !c->parents.empty()) {
+        std::vector<std::string> parents{};
+
+        for (auto&& parent : c->parents) {
+            parents.emplace_back(genny_names.at(parent));
+        }
+
+        out += fmt::format(" : {}", fmt::join(parents, ", "));
+    }
+
+    if (size) {
+        out += fmt::format(" 0x{:X}", *size);
+    }
+
+    out += " {\n";
+
+    if (c != nullptr) {
+        out += fmt::format("{}    // vtable 0x{:X}, {} slots\n", indent, c->vtable, c->num_vfuncs);
+
+        // Derived classes get the vtable from their first parent.
+        if (c->parents.empty() && c->num_vfuncs > 0) {
+            out += fmt::format("{}    {}_vtbl* vtable\n", indent, struct_name);
+        }
+    }
+
+    out += fmt::format("{}}}\n", indent);
+
+    for (size_t i = 0; i + 1 < scopes.size(); ++i) {
+        indent.erase(0, 4);
+        out += fmt::format("{}}}\n", indent);
+    }
+
+    return out;
+}
+
+void RttiExportUi::cancel() {
+    if (m_export.valid()) {
+        m_cancel = true;
+        m_export.wait();
+    }
+}
+
+void RttiExportUi::ui(Process& process) {
+    auto&& modules = process.modules();
+
+    if (modules.empty()) {
+        ImGui::Text("Error: No Process");
+        return;
+    }
+
+    auto exporting = m_export.valid();
+
+    if (exporting && m_export.wait_for(0s) == std::future_status::ready) {
+        m_result = m_export.get();
+        exporting = false;
+    }
+
+    m_module = std::clamp(m_module, 0, (int)modules.size() - 1);
+
+    ImGui::BeginDisabled(exporting);
+
+    auto module_name = [](const Process::Module& module) {
+        return std::filesystem::path{module.name}.filename().string();
+    };
+
+    if (ImGui::BeginCombo("Module", module_name(modules[m_module]).c_str())) {
+        for (auto i = 0; i < (int)modules.size(); ++i) {
+            if (ImGui::Selectable(module_name(modules[i]).c_str(), i == m_module)) {
+                m_module = i;
+            }
+        }
+
+        ImGui::EndCombo();
+    }
+
+    ImGui::InputText("Output", &m_path);
+    ImGui::SameLine();
+
+    if (ImGui::Button("Browse")) {
+        nfdchar_t* out_path{};
+
+        if (NFD_SaveDialog("genny", nullptr, &out_path) == NFD_OKAY) {
+            m_path = out_path;
+            free(out_path);
+        }
+    }
+
+    ImGui::Checkbox("Estimate sizes from instances", &m_infer_sizes);
+
+    if (ImGui::Button("Export") && !m_path.empty()) {
+        m_result = std::nullopt;
+        m_cancel = false;
+        m_export = std::async(std::launch::async, &RttiExportUi::export_classes, std::ref(process),
+            modules[m_module], std::filesystem::path{m_path}, m_infer_sizes, std::cref(m_cancel));
+    }
+
+    ImGui::EndDisabled();
+
+    if (exporting) {
+        ImGui::SameLine();
+
+        if (ImGui::Button("Cancel")) {
+            m_cancel = true;
+        }
+
+        ImGui::TextUnformatted("Exporting...");
+    }
+
+    if (m_result) {
+        if (!m_result->error.empty()) {
+            ImGui::TextColored({1.0f, 0.4f, 0.4f, 1.0f}, "%s", m_result->error.c_str());
+        } else {
+            ImGui::Text("%zu classes (%zu sized) in %.2fs: %zu added, %zu updated, %zu kept", m_result->num_classes,
+                m_result->num_sized, m_result->seconds, m_result->num_added, m_result->num_updated,
+                m_result->num_kept);
+        }
+    }
+}
+
+std::unordered_map<std::string, size_t> RttiExportUi::infer_sizes(
+    Process& process, const std::vector<Process::RttiClass>& classes, const std::atomic<bool>& cancel) {
+    std::unordered_map<uintptr_t, size_t> vtables{};
+    uintptr_t lowest = UINTPTR_MAX;
+    uintptr_t highest{};
+
+    for (size_t i = 0; i < classes.size(); ++i) {
+        vtables.emplace(classes[i].vtable, i);
+        lowest = std::min(lowest, classes[i].vtable);
+        highest = std::max(highest, classes[i].vtable);
+    }
+
+    struct Instance {
+        uintptr_t address{};
+        size_t class_index{};
+    };
+
+    std::vector<std::pair<uintptr_t, uintptr_t>> chunks{};
+
+    for (auto&& allocation : process.allocations()) {
+        if (!allocation.read || !allocation.write) {
+            continue;
+        }
+
+        for (auto start = allocation.start; start < allocation.end; start += chunk_size) {
+            chunks.emplace_back(start, std::min(start + chunk_size, allocation.end));
+        }
+    }
+
+    std::vector<Instance> instances{};
+    std::mutex instances_lock{};
+
+    concurrency::parallel_for(size_t{0}, chunks.size(), [&](size_t i) {
+        if (cancel) {
+            return;
+        }
+
+        ReadGovernor::PriorityScope priority{ReadGovernor::Priority::Scan, &cancel};
+
+        auto [start, end] = chunks[i];
+        std::vector<std::byte> mem(end - start);
+        auto mask = process.read_partial(start, mem.data(), mem.size());
+        std::vector<Instance> local{};
+
+        if (mask.none()) {
+            return;
+        }
+
+        process.with_pointer([&]<typename Ptr>(Ptr) {
+            for (size_t j = 0; j + Ptr::size <= mem.size(); j += Ptr::size) {
+                auto value = Ptr::load(&mem[j]);
+
+                // Cheap range check first, nearly every value fails it.
+                if (value < lowest || value > highest) {
+                    continue;
+                }
+
+                if (auto it = vtables.find(value); it != vtables.end()) {
+                    local.emplace_back(start + j, it->second);
+                }
+            }
+        });
+
+        std::scoped_lock _{instances_lock};
+        instances.insert(instances.end(), local.begin(), local.end());
+    });
+
+    // Instances of the same class tend to be allocated next to each other (pools, arrays, heap buckets) so the most
+    // common distance between neighbouring instances is a good estimate of the size (rounded up to the allocation
+    // granularity).
+    std::sort(instances.begin(), instances.end(), [](auto&& a, auto&& b) { return a.address < b.address; });
+
+    std::vector<uintptr_t> last_seen(classes.size());
+    std::vector<std::unordered_map<size_t, size_t>> gaps(classes.size());
+
+    for (auto&& instance : instances) {
+        auto& last = last_seen[instance.class_index];
+
+        if (last != 0 && instance.address - last <= max_inferred_size) {
+            ++gaps[instance.class_index][instance.address - last];
+        }
+
+        last = instance.address;
+    }
+
+    std::unordered_map<std::string, size_t> sizes{};
+
+    for (size_t i = 0; i < classes.size(); ++i) {
+        auto best = std::max_element(
+            gaps[i].begin(), gaps[i].end(), [](auto&& a, auto&& b) { return a.second < b.second; });
+
+        // A single pair of neighbours isn't enough to go on.
+        if (best != gaps[i].end() && best->second >= 2) {
+            sizes[classes[i].name] = best->first;
+        }
+    }
+
+    return sizes;
+}
+
+RttiExportUi::Result RttiExportUi::export_classes(Process& process, const Process::Module& module,
+    const std::filesystem::path& path, bool infer_sizes, const std::atomic<bool>& cancel) try {
+    auto start_time = std::chrono::steady_clock::now();
+    ReadGovernor::PriorityScope priority{ReadGovernor::Priority::Scan, &cancel};
+    Result result{};
+
+    auto classes = process.rtti_classes(module);
+
+    if (classes.empty()) {
+        result.error = "No RTTI found in " + module.name;
+        return result;
+    }
+
+    std::unordered_map<std::string, size_t> sizes{};
+
+    if (infer_sizes) {
+        sizes = RttiExportUi::infer_sizes(process, classes, cancel);
+    }
+
+    if (cancel) {
+        result.error = "Cancelled";
+        return result;
+    }
+
+    // Bases without a vtable of their own (or from another module) only show up as parents. They get empty structs so
+    // the classes deriving from them still parse.
+    std::unordered_map<std::string, const Process::RttiClass*> by_name{};
+    std::unordered_map<std::string, std::string> genny_names{};
+    std::vector<std::string> names{};
+
+    for (auto&& c : classes) {
+        by_name.emplace(c.name, &c);
+    }
+
+    std::unordered_set<std::string> used_genny_names{};
+
+    auto add_name = [&](const std::string& name) {
+        if (genny_names.contains(name)) {
+            return;
+        }
+
+        std::vector<std::string> scopes{};
+
+        for (auto&& scope : split_scopes(name)) {
+            scopes.emplace_back(to_identifier(scope));
+        }
+
+        // Different template instances can end up with the same identifier.
+        auto genny_name = fmt::format("{}", fmt::join(scopes, "."));
+
+        for (auto i = 2; used_genny_names.contains(genny_name); ++i) {
+            genny_name = fmt::format("{}_{}", fmt::join(scopes, "."), i);
+        }
+
+        used_genny_names.emplace(genny_name);
+        genny_names.emplace(name, genny_name);
+        names.emplace_back(name);
+    };
+
+    for (auto&& c : classes) {
+        add_name(c.name);
+
+        for (auto&& parent : c.parents) {
+            add_name(parent);
+        }
+    }
+
+    // Parents have to be declared before the classes deriving from them.
+    std::vector<std::string> order{};
+    std::unordered_set<std::string> visited{};
+    std::function<void(const std::string&)> visit = [&](const std::string& name) {
+        if (!visited.emplace(name).second) {
+            return;
+        }
+
+        if (auto it = by_name.find(name); it != by_name.end()) {
+            for (auto&& parent : it->second->parents) {
+                visit(parent);
+            }
+        }
+
+        order.emplace_back(name);
+    };
+
+    std::sort(names.begin(), names.end());
+
+    for (auto&& name : names) {
+        visit(name);
+    }
+
+    // Blocks are keyed by genny name since the undecorated names can contain spaces.
+    std::unordered_map<std::string, std::string> blocks{};
+
+    for (auto&& name : order) {
+        auto it = by_name.find(name);
+        auto c = it != by_name.end() ? it->second : nullptr;
+        std::optional<size_t> size{};
+
+        if (auto size_it = sizes.find(name); size_it != sizes.end()) {
+            size = size_it->second;
+
+            // The estimate is no good if it's smaller than a parent (parents come first so theirs are final).
+            auto too_small = c != nullptr && std::any_of(c->parents.begin(), c->parents.end(), [&](auto&& parent) {
+                auto parent_it = sizes.find(parent);
+                return parent_it != sizes.end() && parent_it->second > *size;
+            });
+
+            if (too_small) {
+                size = std::nullopt;
+                sizes.erase(size_it);
+            }
+        }
+
+        if (size) {
+            ++result.num_sized;
+        }
+
+        blocks.emplace(genny_names.at(name), class_block(genny_names.at(name), c, genny_names, size));
+    }
+
+    result.num_classes = classes.size();
+
+    // Merge with what's already in the file.
+    std::vector<std::string> lines{};
+    std::unordered_set<std::string> existing{};
+
+    if (std::ifstream f{path}; f) {
+        for (std::string line{}; std::getline(f, line);) {
+            if (line.starts_with("// rtti ")) {
+                std::istringstream header{line.substr(8)};
+                std::string name{};
+
+                header >> name;
+                existing.emplace(name);
+            }
+
+            lines.emplace_back(std::move(line));
+        }
+    }
+
+    std::string out{};
+    std::unordered_set<std::string> written{};
+
+    auto add_block = [&](const std::string& name) {
+        auto& body = blocks.at(name);
+
+        if (!out.empty() && !out.ends_with("\n\n")) {
+            out += '\n';
+        }
+
+        out += fmt::format("// rtti {} {:08x}\n{}// end rtti {}\n", name, fnv1a(body), body, name);
+        written.emplace(name);
+        ++result.num_added;
+    };
+
+    std::unordered_map<std::string, std::string> undecorated_names{};
+    std::unordered_map<std::string, size_t> positions{};
+
+    for (size_t i = 0; i < order.size(); ++i) {
+        undecorated_names.emplace(genny_names.at(order[i]), order[i]);
+        positions.emplace(order[i], i);
+    }
+
+    // A base that's new to the file goes right before the first block deriving from it, which wouldn't parse if the
+    // base only came at the end.
+    auto add_missing_bases = [&](const std::string& name) {
+        auto it = undecorated_names.find(name);
+
+        if (it == undecorated_names.end()) {
+            return;
+        }
+
+        std::vector<std::string> missing{};
+        std::unordered_set<std::string> seen{};
+        std::function<void(const std::string&)> collect = [&](const std::string& derived) {
+            if (auto c = by_name.find(derived); c != by_name.end()) {
+                for (auto&& parent : c->second->parents) {
+                    if (!seen.emplace(parent).second) {
+                        continue;
+                    }
+
+                    auto& genny_name = genny_names.at(parent);
+
+                    if (!existing.contains(genny_name) && !written.contains(genny_name)) {
+                        missing.emplace_back(parent);
+                    }
+
+                    collect(parent);
+                }
+            }
+        };
+
+        collect(it->second);
+
+        // Bases before the classes deriving from them, same as order.
+        std::sort(missing.begin(), missing.end(),
+            [&](auto&& a, auto&& b) { return positions.at(a) < positions.at(b); });
+
+        for (auto&& base : missing) {
+            add_block(genny_names.at(base));
+        }
+
+        if (!missing.empty()) {
+            out += '\n';
+        }
+    };
+
+    {
+        std::optional<std::string> block_name{};
+        uint32_t block_hash{};
+        std::string block_header{};
+        std::string block_body{};
+
+        for (auto&& line : lines) {
+            if (!block_name && line.starts_with("// rtti ")) {
+                std::istringstream header{line.substr(8)};
+                std::string name{};
+                std::string hash{};
+
+                header >> name >> hash;
+                block_name = name;
+                block_hash = (uint32_t)std::stoul(hash.empty() ? "0"s : hash, nullptr, 16);
+                block_header = line + '\n';
+                block_body.clear();
+            } else if (block_name && line == "// end rtti " + *block_name) {
+                auto regenerate = blocks.contains(*block_name) && fnv1a(block_body) == block_hash;
+
+                add_missing_bases(*block_name);
+
+                if (regenerate) {
+                    auto& body = blocks.at(*block_name);
+                    out += fmt::format("// rtti {} {:08x}\n{}{}\n", *block_name, fnv1a(body), body, line);
+                    ++result.num_updated;
+                } else {
+                    out += block_header + block_body + line + '\n';
+
+                    if (blocks.contains(*block_name)) {
+                        ++result.num_kept;
+                    }
+                }
+
+                written.emplace(*block_name);
+                block_name = std::nullopt;
+            } else if (block_name) {
+                block_body += line + '\n';
+            } else {
+                out += line + '\n';
+            }
+        }
+
+        // An unterminated block was probably edited by hand so keep it as is.
+        if (block_name) {
+            add_missing_bases(*block_name);
+            out += block_header + block_body;
+            written.emplace(*block_name);
+        }
+    }
+
+    for (auto&& undecorated_name : order) {
+        auto& name = genny_names.at(undecorated_name);
+
+        if (!written.contains(name)) {
+            add_block(name);
+        }
+    }
+
+    // Write to a temporary file first so a failure doesn't leave the file half written.
+    auto tmp_path = path;
+    tmp_path += ".tmp";
+
+    {
+        std::ofstream f{tmp_path, std::ios::binary};
+        f << out;
+
+        if (!f) {
+            result.error = "Failed to write " + tmp_path.string();
+            return result;
+        }
+    }
+
+    std::filesystem::rename(tmp_path, path);
+
+    result.seconds = std::chrono::duration<double>{std::chrono::steady_clock::now() - start_time}.count();
+    spdlog::info("Exported {} RTTI classes from {} to {} in {:.2f}s ({} added, {} updated, {} kept)",
+        result.num_classes, module.name, path.string(), result.seconds, result.num_added, result.num_updated,
+        result.num_kept);
+
+    return result;
+} catch (const std::exception& e) {
+    spdlog::error("RTTI export failed: {}", e.what());
+    return Result{.error = e.what()};
+}
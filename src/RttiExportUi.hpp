@@ -0,0 +1,52 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <future>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Process.hpp"
+
+// Writes a .genny skeleton of every class in a module's RTTI: namespaces from the undecorated names, parents from the
+// class hierarchy, a placeholder struct sized for each vtable and sizes estimated from instances found in memory.
+//
+// Every class is written as a block between "// rtti <name> <hash>" and "// end rtti <name>" comments. Exporting into
+// an existing file regenerates the blocks whose hash still matches their contents, keeps the blocks (and anything
+// outside of them) that were edited by hand and appends new classes at the end.
+class RttiExportUi {
+public:
+    struct Result {
+        size_t num_classes{};
+        size_t num_sized{};
+        size_t num_added{};
+        size_t num_updated{};
+        size_t num_kept{};
+        double seconds{};
+        std::string error{};
+    };
+
+    ~RttiExportUi() { cancel(); }
+
+    // Stops an export that's running and waits for it (call before the process it's reading goes away).
+    void cancel();
+    void ui(Process& process);
+
+    // Class name -> estimated size.
+    static std::unordered_map<std::string, size_t> infer_sizes(
+        Process& process, const std::vector<Process::RttiClass>& classes, const std::atomic<bool>& cancel);
+    static Result export_classes(Process& process, const Process::Module& module, const std::filesystem::path& path,
+        bool infer_sizes, const std::atomic<bool>& cancel);
+
+private:
+    int m_module{};
+    bool m_infer_sizes{true};
+    std::string m_path{};
+
+    std::future<Result> m_export{};
+    std::atomic<bool> m_cancel{};
+    std::optional<Result> m_result{};
+};
@@ -0,0 +1,630 @@
+#include <algorithm>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <set>
+#include <utility>
+
+#include <spdlog/spdlog.h>
+
+#include "Config.hpp"
+#include "Trace.hpp"
+#include "node/Elements.hpp"
+#include "node/Factory.hpp"
+#include "node/LayoutCache.hpp"
+#include "node/Pointer.hpp"
+
+#include "Snapshot.hpp"
+
+namespace {
+// Followed by everything in our own byte order, ReGenny only runs on little endian hosts.
+constexpr char snapshot_magic[8]{'R', 'G', 'S', 'N', 'A', 'P', 0, 0};
+constexpr uint32_t snapshot_version = 1;
+
+uintptr_t page_of(uintptr_t address) {
+    return address & ~(Process::page_size - 1);
+}
+
+// Whether there can be anything to follow in a value of type.
+bool can_point(sdkgenny::Type* type) {
+    return type->is_a<sdkgenny::Struct>() || type->is_a<sdkgenny::Array>() || type->is_a<sdkgenny::Pointer>();
+}
+
+// Stands in for the process while a container or walker node finds its elements, so the capture gets the memory it
+// went through on the way (list and tree links, string characters).
+class Recorder : public Process {
+public:
+    explicit Recorder(Process& process) : m_process{process} {
+        m_pointer_size = process.pointer_size();
+        m_endianness = process.endianness();
+    }
+
+    auto&& reads() const { return m_reads; }
+
+protected:
+    bool handle_write(uintptr_t address, const void* buffer, size_t size) override { return false; }
+    bool handle_read(uintptr_t address, void* buffer, size_t size) override {
+        m_reads.emplace_back(address, size);
+        return m_process.read(address, buffer, size);
+    }
+
+private:
+    Process& m_process;
+    std::vector<std::pair<uintptr_t, size_t>> m_reads{};
+};
+
+class Capture {
+public:
+    Capture(Process& process, int depth, const std::atomic<bool>& cancel, std::atomic<float>& progress)
+        : m_process{process}, m_depth{depth}, m_cancel{cancel}, m_progress{progress} {}
+
+    // Returns nothing if it was cancelled.
+    std::optional<Snapshot> run(sdkgenny::Struct* type, uintptr_t address);
+
+private:
+    struct Item {
+        uintptr_t address{};
+        sdkgenny::Type* type{};
+        int depth{};
+    };
+
+    Process& m_process;
+    int m_depth{};
+    const std::atomic<bool>& m_cancel;
+    std::atomic<float>& m_progress;
+    std::map<uintptr_t, std::vector<std::byte>> m_pages{};
+    MemoryAccountant::Usage m_pages_usage{MemoryAccountant::Category::Snapshots};
+    std::set<uintptr_t> m_bad_pages{};
+    std::set<std::pair<uintptr_t, sdkgenny::Type*>> m_visited{};
+    std::deque<Item> m_queue{};
+    std::map<uintptr_t, std::string> m_typenames{};
+    bool m_truncated{};
+    // For the container and walker nodes, which only look at the display options.
+    Config m_cfg{};
+    std::map<sdkgenny::Variable*, std::optional<node::Pointer::CountField>> m_count_fields{};
+
+    bool has_page(uintptr_t page) const { return m_pages.contains(page) || m_bad_pages.contains(page); }
+    void add(uintptr_t address, size_t size);
+    bool copy(uintptr_t address, void* out, size_t size) const;
+    std::optional<uintptr_t> load_pointer(uintptr_t address) const;
+    sdkgenny::Struct* label(uintptr_t address, sdkgenny::Struct* declared);
+    void visit(const Item& item);
+    void walk(uintptr_t address, sdkgenny::Type* type, sdkgenny::Variable* var, int depth);
+    void follow(uintptr_t address, sdkgenny::Pointer* ptr, sdkgenny::Variable* var, int depth);
+    size_t count_of(uintptr_t address, sdkgenny::Variable* var);
+    void elements(uintptr_t address, sdkgenny::Variable* var, node::NodeKind kind, int depth);
+};
+
+std::optional<Snapshot> Capture::run(sdkgenny::Struct* type, uintptr_t address) {
+    ReadGovernor::PriorityScope priority{ReadGovernor::Priority::Scan, &m_cancel};
+    Snapshot snapshot{};
+
+    snapshot.pointer_size = m_process.pointer_size();
+    snapshot.endianness = m_process.endianness();
+    snapshot.root = address;
+    snapshot.modules = m_process.modules();
+
+    m_visited.emplace(address, type);
+    m_queue.emplace_back(address, type, 0);
+
+    while (!m_queue.empty() && !m_truncated) {
+        if (m_cancel) {
+            return std::nullopt;
+        }
+
+        auto item = m_queue.front();
+
+        // The queue is breadth first so how deep it's got is as close to a fraction done as there is.
+        m_progress = (float)item.depth / (m_depth + 1);
+        m_queue.pop_front();
+        visit(item);
+    }
+
+    for (auto&& [page, mem] : m_pages) {
+        if (!snapshot.ranges.empty()) {
+            auto& [start, range] = *snapshot.ranges.rbegin();
+
+            if (start + range.size() == page) {
+                range.insert(range.end(), mem.begin(), mem.end());
+                continue;
+            }
+        }
+
+        snapshot.ranges.emplace(page, std::move(mem));
+    }
+
+    m_pages.clear();
+    m_pages_usage.set(0);
+
+    snapshot.typenames = std::move(m_typenames);
+    snapshot.truncated = m_truncated;
+
+    return snapshot;
+}
+
+void Capture::add(uintptr_t address, size_t size) {
+    if (size == 0) {
+        return;
+    }
+
+    auto first = page_of(address);
+    auto last = page_of(address + size - 1);
+
+    // Only the span between the first and last pages we don't have yet gets read, in one read_partial.
+    for (; first <= last && has_page(first); first += Process::page_size) {
+    }
+
+    for (; last > first && has_page(last); last -= Process::page_size) {
+    }
+
+    if (first > last) {
+        return;
+    }
+
+    if (m_pages.size() * Process::page_size >= Snapshot::max_bytes) {
+        m_truncated = true;
+        return;
+    }
+
+    std::vector<std::byte> buffer(last - first + Process::page_size);
+    auto mask = m_process.read_partial(first, buffer.data(), buffer.size());
+
+    // Pages a cancelled read didn't get to aren't bad, and the capture is about to be thrown away anyway.
+    if (mask.canceled) {
+        return;
+    }
+
+    for (size_t i = 0; i < mask.valid.size(); ++i) {
+        auto page = mask.first_page + i * Process::page_size;
+
+        if (!mask.valid[i]) {
+            m_bad_pages.emplace(page);
+            continue;
+        }
+
+        auto mem = buffer.begin() + i * Process::page_size;
+        m_pages.try_emplace(page, mem, mem + Process::page_size);
+    }
+
+    m_pages_usage.set(m_pages.size() * Process::page_size);
+}
+
+bool Capture::copy(uintptr_t address, void* out, size_t size) const {
+    auto dst = (std::byte*)out;
+
+    while (size > 0) {
+        auto page = page_of(address);
+        auto it = m_pages.find(page);
+
+        if (it == m_pages.end()) {
+            return false;
+        }
+
+        auto offset = address - page;
+        auto n = std::min(size, Process::page_size - offset);
+
+        memcpy(dst, it->second.data() + offset, n);
+        dst += n;
+        address += n;
+        size -= n;
+    }
+
+    return true;
+}
+
+std::optional<uintptr_t> Capture::load_pointer(uintptr_t address) const {
+    uint64_t value{};
+
+    if (!copy(address, &value, m_process.pointer_size())) {
+        return std::nullopt;
+    }
+
+    return m_process.load_pointer(&value);
+}
+
+// Records the RTTI name of the object at address (if it has one) and returns the struct the memory view would display
+// it as, see Pointer::pointee.
+sdkgenny::Struct* Capture::label(uintptr_t address, sdkgenny::Struct* declared) {
+    auto vtable = load_pointer(address);
+
+    if (!vtable || m_process.get_module_within(*vtable) == nullptr) {
+        return declared;
+    }
+
+    auto it = m_typenames.find(*vtable);
+
+    if (it == m_typenames.end()) {
+        auto name = m_process.get_typename_from_vtable(*vtable);
+
+        if (!name) {
+            return declared;
+        }
+
+        it = m_typenames.emplace(*vtable, std::move(*name)).first;
+
+        // The vtable itself (and the slot before it) so it reads the same when expanded.
+        add(*vtable - m_process.pointer_size(), m_process.pointer_size() * 8);
+    }
+
+    auto derived = node::Pointer::find_struct(declared, it->second);
+
+    if (derived != nullptr && derived != declared && node::Pointer::derives_from(derived, declared)) {
+        return derived;
+    }
+
+    return declared;
+}
+
+void Capture::visit(const Item& item) {
+    auto type = item.type;
+
+    if (auto struct_ = dynamic_cast<sdkgenny::Struct*>(type)) {
+        add(item.address, node::LayoutCache::size(struct_));
+        type = label(item.address, struct_);
+    }
+
+    add(item.address, node::LayoutCache::size(type));
+    walk(item.address, type, nullptr, item.depth);
+}
+
+void Capture::walk(uintptr_t address, sdkgenny::Type* type, sdkgenny::Variable* var, int depth) {
+    if (auto struct_ = dynamic_cast<sdkgenny::Struct*>(type)) {
+        label(address, struct_);
+
+        for (auto&& member : node::LayoutCache::layout(struct_).members) {
+            switch (member.kind) {
+            case node::NodeKind::Struct:
+            case node::NodeKind::Array:
+            case node::NodeKind::Pointer:
+                walk(address + member.offset, member.var->type(), member.var, depth);
+                break;
+            case node::NodeKind::Container:
+            case node::NodeKind::Walker:
+                elements(address + member.offset, member.var, member.kind, depth);
+                break;
+            default:
+                break;
+            }
+        }
+    } else if (auto arr = dynamic_cast<sdkgenny::Array*>(type)) {
+        auto of = arr->of();
+
+        // Nothing to follow in arrays of plain values.
+        if (!can_point(of)) {
+            return;
+        }
+
+        auto element_size = node::LayoutCache::size(of);
+
+        for (size_t i = 0; i < arr->count(); ++i) {
+            walk(address + i * element_size, of, nullptr, depth);
+        }
+    } else if (auto ptr = dynamic_cast<sdkgenny::Pointer*>(type)) {
+        follow(address, ptr, var, depth);
+    }
+}
+
+void Capture::follow(uintptr_t address, sdkgenny::Pointer* ptr, sdkgenny::Variable* var, int depth) {
+    if (depth >= m_depth) {
+        return;
+    }
+
+    auto target = load_pointer(address);
+
+    if (!target || *target == 0) {
+        return;
+    }
+
+    // The strings the pointer node previews.
+    if (var != nullptr) {
+        for (auto&& md : var->metadata()) {
+            auto char_size = md == "utf8*" ? 1 : md == "utf16*" ? 2 : md == "utf32*" ? 4 : 0;
+
+            if (char_size != 0) {
+                add(*target, 256 * char_size);
+                return;
+            }
+        }
+    }
+
+    auto to = ptr->to();
+    auto size = node::LayoutCache::size(to);
+    auto count = count_of(address, var);
+
+    // Arrays bound to a count are captured whole, their elements are only visited when there's something to follow.
+    if (count != 1) {
+        add(*target, count * size);
+
+        if (!can_point(to)) {
+            return;
+        }
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+        if (m_visited.emplace(*target + i * size, to).second) {
+            m_queue.emplace_back(*target + i * size, to, depth + 1);
+        }
+    }
+}
+
+// The number of elements a pointer points to. It's read from the field of a [[count:<field>]] binding (clamped like
+// the pointer node does by default) and is 1 for pointers that aren't bound.
+size_t Capture::count_of(uintptr_t address, sdkgenny::Variable* var) {
+    if (var == nullptr) {
+        return 1;
+    }
+
+    auto it = m_count_fields.find(var);
+
+    if (it == m_count_fields.end()) {
+        std::optional<node::Pointer::CountField> field{};
+
+        for (auto&& md : var->metadata()) {
+            if (md.starts_with("count:")) {
+                field = node::Pointer::find_count_field(var, md.substr(6));
+            }
+        }
+
+        it = m_count_fields.emplace(var, field).first;
+    }
+
+    if (!it->second) {
+        return 1;
+    }
+
+    // The field is in the struct the pointer is in, which has been captured already.
+    auto& field = *it->second;
+    auto start = std::min(address, address + field.offset);
+    auto end = std::max(address + var->size(), address + field.offset + field.size);
+    std::vector<std::byte> mem(end - start);
+
+    if (!copy(start, mem.data(), mem.size())) {
+        return 0;
+    }
+
+    return (size_t)std::min<uint64_t>(field.load(mem.data() + (address - start)), node::Pointer::default_max_count);
+}
+
+// Containers and walkers find their elements the same way their nodes do. The node is made just for that, on a
+// Recorder so whatever it read to find them is captured too.
+void Capture::elements(uintptr_t address, sdkgenny::Variable* var, node::NodeKind kind, int depth) {
+    if (depth >= m_depth) {
+        return;
+    }
+
+    std::vector<std::byte> mem(var->size());
+
+    if (!copy(address, mem.data(), mem.size())) {
+        return;
+    }
+
+    Recorder recorder{m_process};
+    node::Property props{};
+    auto node = node::make_node(m_cfg, recorder, var, props, kind);
+    auto elements = dynamic_cast<node::Elements*>(node.get());
+
+    if (elements == nullptr) {
+        return;
+    }
+
+    auto addresses = elements->find_all_elements(address, mem.data());
+    auto type = elements->type_of_elements();
+
+    for (auto&& [start, size] : recorder.reads()) {
+        add(start, size);
+    }
+
+    for (auto element : addresses) {
+        if (m_visited.emplace(element, type).second) {
+            m_queue.emplace_back(element, type, depth + 1);
+        }
+    }
+}
+} // namespace
+
+std::filesystem::path snapshot_path(const std::filesystem::path& genny_path) {
+    auto path = genny_path;
+    path.replace_extension("snapshot");
+    return path;
+}
+
+size_t Snapshot::num_bytes() const {
+    size_t n{};
+
+    for (auto&& [start, mem] : ranges) {
+        n += mem.size();
+    }
+
+    return n;
+}
+
+std::optional<Snapshot> Snapshot::capture(Process& process, sdkgenny::Struct* type, uintptr_t address, int depth,
+    const std::atomic<bool>& cancel, std::atomic<float>& progress) {
+    TRACE_SCOPE("snapshot_capture", "snapshot");
+    return Capture{process, depth, cancel, progress}.run(type, address);
+}
+
+bool Snapshot::save(const std::filesystem::path& path) const {
+    std::ofstream f{path, std::ios::binary};
+
+    if (!f) {
+        spdlog::error("Couldn't open {} for writing", path.string());
+        return false;
+    }
+
+    auto write = [&f](const auto& value) { f.write((const char*)&value, sizeof(value)); };
+    auto write_str = [&](const std::string& s) {
+        write((uint32_t)s.size());
+        f.write(s.data(), s.size());
+    };
+
+    f.write(snapshot_magic, sizeof(snapshot_magic));
+    write(snapshot_version);
+    write((uint32_t)pointer_size);
+    write((uint32_t)(endianness == std::endian::big));
+    write((uint64_t)root);
+
+    write((uint32_t)modules.size());
+
+    for (auto&& mod : modules) {
+        write_str(mod.name);
+        write((uint64_t)mod.start);
+        write((uint64_t)mod.end);
+    }
+
+    write((uint32_t)typenames.size());
+
+    for (auto&& [vtable, name] : typenames) {
+        write((uint64_t)vtable);
+        write_str(name);
+    }
+
+    write((uint32_t)ranges.size());
+
+    for (auto&& [start, mem] : ranges) {
+        write((uint64_t)start);
+        write((uint64_t)mem.size());
+        f.write((const char*)mem.data(), mem.size());
+    }
+
+    return f.good();
+}
+
+std::optional<Snapshot> Snapshot::load(const std::filesystem::path& path) {
+    std::error_code ec{};
+    auto file_size = std::filesystem::file_size(path, ec);
+    std::ifstream f{path, std::ios::binary};
+
+    if (ec || !f) {
+        spdlog::error("Couldn't open {}", path.string());
+        return std::nullopt;
+    }
+
+    auto read = [&f](auto& value) { return (bool)f.read((char*)&value, sizeof(value)); };
+    // Lengths are checked against the file size so a corrupt file can't make us allocate gigabytes.
+    auto read_bytes = [&](auto& out, uint64_t size) {
+        if (size > file_size) {
+            return false;
+        }
+
+        out.resize(size);
+        return (bool)f.read((char*)out.data(), size);
+    };
+    auto read_str = [&](std::string& s) {
+        uint32_t size{};
+        return read(size) && read_bytes(s, size);
+    };
+
+    char magic[sizeof(snapshot_magic)]{};
+    uint32_t version{};
+    uint32_t pointer_size{};
+    uint32_t big_endian{};
+    uint64_t root{};
+
+    if (!read(magic) || memcmp(magic, snapshot_magic, sizeof(magic)) != 0 || !read(version) ||
+        version != snapshot_version) {
+        spdlog::error("{} isn't a snapshot (or is from a different version of ReGenny)", path.string());
+        return std::nullopt;
+    }
+
+    Snapshot snapshot{};
+    uint32_t num_modules{};
+    uint32_t num_typenames{};
+    uint32_t num_ranges{};
+    auto ok = read(pointer_size) && read(big_endian) && read(root) && read(num_modules);
+
+    snapshot.pointer_size = pointer_size;
+    snapshot.endianness = big_endian != 0 ? std::endian::big : std::endian::little;
+    snapshot.root = (uintptr_t)root;
+
+    for (uint32_t i = 0; ok && i < num_modules; ++i) {
+        Process::Module mod{};
+        uint64_t start{};
+        uint64_t end{};
+
+        ok = read_str(mod.name) && read(start) && read(end);
+        mod.start = (uintptr_t)start;
+        mod.end = (uintptr_t)end;
+        mod.size = mod.end - mod.start;
+        snapshot.modules.emplace_back(std::move(mod));
+    }
+
+    ok = ok && read(num_typenames);
+
+    for (uint32_t i = 0; ok && i < num_typenames; ++i) {
+        uint64_t vtable{};
+        std::string name{};
+
+        ok = read(vtable) && read_str(name);
+        snapshot.typenames.emplace((uintptr_t)vtable, std::move(name));
+    }
+
+    ok = ok && read(num_ranges);
+
+    for (uint32_t i = 0; ok && i < num_ranges; ++i) {
+        uint64_t start{};
+        uint64_t size{};
+        std::vector<std::byte> mem{};
+
+        ok = read(start) && read(size) && read_bytes(mem, size);
+        snapshot.ranges.emplace((uintptr_t)start, std::move(mem));
+    }
+
+    if (!ok || (pointer_size != 4 && pointer_size != 8)) {
+        spdlog::error("{} is truncated or corrupt", path.string());
+        return std::nullopt;
+    }
+
+    return snapshot;
+}
+
+SnapshotProcess::SnapshotProcess(Snapshot snapshot) : m_snapshot{std::move(snapshot)} {
+    m_usage.set(m_snapshot.num_bytes());
+    m_pointer_size = m_snapshot.pointer_size;
+    m_endianness = m_snapshot.endianness;
+    m_modules = m_snapshot.modules;
+
+    for (auto&& [start, mem] : m_snapshot.ranges) {
+        Allocation allocation{};
+
+        allocation.start = start;
+        allocation.size = mem.size();
+        allocation.end = start + mem.size();
+        allocation.read = true;
+        m_allocations.emplace_back(allocation);
+    }
+}
+
+std::optional<std::string> SnapshotProcess::get_typename(uintptr_t ptr) {
+    if (auto vtable = read_pointer(ptr)) {
+        return get_typename_from_vtable(*vtable);
+    }
+
+    return std::nullopt;
+}
+
+std::optional<std::string> SnapshotProcess::get_typename_from_vtable(uintptr_t ptr) {
+    if (auto it = m_snapshot.typenames.find(ptr); it != m_snapshot.typenames.end()) {
+        return it->second;
+    }
+
+    return std::nullopt;
+}
+
+bool SnapshotProcess::handle_read(uintptr_t address, void* buffer, size_t size) {
+    // Ranges are merged when captured so a read is either within one of them or (partly) outside the snapshot.
+    auto it = m_snapshot.ranges.upper_bound(address);
+
+    if (it == m_snapshot.ranges.begin()) {
+        return false;
+    }
+
+    auto& [start, mem] = *--it;
+
+    if (address + size > start + mem.size()) {
+        return false;
+    }
+
+    memcpy(buffer, mem.data() + (address - start), size);
+    return true;
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <sdkgenny.hpp>
+
+#include "MemoryAccountant.hpp"
+#include "Process.hpp"
+
+// The part of a process a type at an address can see: the pages reachable from it through typed pointers (up to a
+// depth), the RTTI names of the polymorphic objects among them and the module list. Saved next to a project's .genny
+// files it makes a bundle that opens in SnapshotProcess with the same view, without the rest of the process.
+struct Snapshot {
+    // Safety net for pointer graphs that fan out a lot, the capture stops following pointers past this.
+    static constexpr size_t max_bytes = 256 * 1024 * 1024;
+
+    size_t pointer_size{sizeof(uintptr_t)};
+    std::endian endianness{std::endian::native};
+    uintptr_t root{};
+    std::vector<Process::Module> modules{};
+    // Captured memory keyed by start address. Ranges are page aligned and adjacent ones are merged.
+    std::map<uintptr_t, std::vector<std::byte>> ranges{};
+    // Vtable -> RTTI name, for every polymorphic object captured.
+    std::map<uintptr_t, std::string> typenames{};
+    // Set when max_bytes was reached before everything reachable was captured.
+    bool truncated{};
+
+    size_t num_bytes() const;
+
+    // Captures type at address and everything it points to, breadth first, up to depth pointers away. Pointers are
+    // followed to the type the memory view would display (ie. downcast through RTTI), strings are captured for
+    // utf8*/utf16*/utf32* pointers, arrays bound to a count whole and containers and walkers element by element (their
+    // elements are a pointer away). Reads are made at scan priority. Returns nothing if cancel was set before it was
+    // done.
+    static std::optional<Snapshot> capture(Process& process, sdkgenny::Struct* type, uintptr_t address, int depth,
+        const std::atomic<bool>& cancel, std::atomic<float>& progress);
+
+    bool save(const std::filesystem::path& path) const;
+    static std::optional<Snapshot> load(const std::filesystem::path& path);
+};
+
+// foo.genny -> foo.snapshot
+std::filesystem::path snapshot_path(const std::filesystem::path& genny_path);
+
+// A read only process backed by a Snapshot. Anything outside the captured ranges is unreadable.
+class SnapshotProcess : public Process {
+public:
+    explicit SnapshotProcess(Snapshot snapshot);
+
+    std::optional<std::string> get_typename(uintptr_t ptr) override;
+    std::optional<std::string> get_typename_from_vtable(uintptr_t ptr) override;
+
+    auto&& snapshot() const { return m_snapshot; }
+
+protected:
+    bool handle_write(uintptr_t address, const void* buffer, size_t size) override { return false; }
+    bool handle_read(uintptr_t address, void* buffer, size_t size) override;
+
+private:
+    Snapshot m_snapshot{};
+    MemoryAccountant::Usage m_usage{MemoryAccountant::Category::Snapshots};
+};
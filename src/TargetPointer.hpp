@@ -0,0 +1,43 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+// A pointer as it's stored in the target, which isn't necessarily how we store them (eg. a 32-bit process inspected
+// from a 64-bit build). Loops over target memory are written as templates over one of these and dispatched once with
+// with_target_pointer, so every layout gets its own instantiation without a branch per pointer.
+template <typename T, std::endian Endian> struct TargetPointer {
+    using Type = T;
+    static constexpr size_t size = sizeof(T);
+    static constexpr std::endian endian = Endian;
+
+    static uintptr_t load(const void* p) {
+        T value{};
+        memcpy(&value, p, sizeof(T));
+
+        if constexpr (Endian != std::endian::native) {
+            value = std::byteswap(value);
+        }
+
+        return (uintptr_t)value;
+    }
+};
+
+// Calls fn with a TargetPointer for the given layout and returns whatever it returns.
+template <typename Fn> decltype(auto) with_target_pointer(size_t size, std::endian endian, Fn&& fn) {
+    if (endian == std::endian::big) {
+        if (size == 4) {
+            return fn(TargetPointer<uint32_t, std::endian::big>{});
+        }
+
+        return fn(TargetPointer<uint64_t, std::endian::big>{});
+    }
+
+    if (size == 4) {
+        return fn(TargetPointer<uint32_t, std::endian::little>{});
+    }
+
+    return fn(TargetPointer<uint64_t, std::endian::little>{});
+}
@@ -0,0 +1,192 @@
+#include <fstream>
+#include <string>
+
+#include <fmt/format.h>
+#include <spdlog/spdlog.h>
+
+#include "Trace.hpp"
+
+std::atomic<bool> Trace::s_enabled{};
+std::atomic<uint32_t> Trace::s_session{};
+
+static void append_json_string(std::string& out, const char* s) {
+    out += '"';
+
+    for (; s != nullptr && *s != '\0'; ++s) {
+        if (*s == '"' || *s == '\\') {
+            out += '\\';
+            out += *s;
+        } else if ((unsigned char)*s < 0x20) {
+            fmt::format_to(std::back_inserter(out), "\\u{:04x}", (unsigned char)*s);
+        } else {
+            out += *s;
+        }
+    }
+
+    out += '"';
+}
+
+void Trace::Scope::begin(const char* name, const char* category) {
+    m_session = s_session.load(std::memory_order_relaxed);
+    m_event.name = name;
+    m_event.category = category;
+    m_event.start_ns = get().now_ns();
+}
+
+void Trace::Scope::end() {
+    auto& trace = get();
+
+    m_event.duration_ns = trace.now_ns() - m_event.start_ns;
+    trace.record(m_event, m_session);
+}
+
+Trace& Trace::get() {
+    static Trace trace{};
+    return trace;
+}
+
+void Trace::set_thread_name(const char* name) {
+    get().thread_buffer().name = name;
+}
+
+void Trace::start() {
+    ++s_session;
+    s_enabled = true;
+    spdlog::info("Tracing started");
+}
+
+size_t Trace::stop(const std::filesystem::path& path) {
+    s_enabled = false;
+
+    auto session = s_session.load();
+    std::string out{"{\"traceEvents\":[\n"};
+    size_t num_events{};
+    auto first = true;
+
+    auto separator = [&] {
+        if (!first) {
+            out += ",\n";
+        }
+
+        first = false;
+    };
+
+    {
+        std::scoped_lock _{m_buffers_lock};
+
+        for (auto&& buffer : m_buffers) {
+            if (buffer->session.load(std::memory_order_acquire) != session) {
+                continue;
+            }
+
+            separator();
+            fmt::format_to(std::back_inserter(out),
+                "{{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":{},\"args\":{{\"name\":", buffer->tid);
+
+            if (auto name = buffer->name.load()) {
+                append_json_string(out, name);
+            } else {
+                append_json_string(out, fmt::format("thread {}", buffer->tid).c_str());
+            }
+
+            out += "}}";
+
+            for (auto chunk = buffer->head.load(std::memory_order_acquire); chunk != nullptr;
+                 chunk = chunk->next.load(std::memory_order_acquire)) {
+                auto count = chunk->count.load(std::memory_order_acquire);
+
+                for (size_t i = 0; i < count; ++i) {
+                    auto& event = chunk->events[i];
+
+                    separator();
+                    out += "{\"name\":";
+                    append_json_string(out, event.name);
+                    out += ",\"cat\":";
+                    append_json_string(out, event.category);
+                    fmt::format_to(std::back_inserter(out),
+                        ",\"ph\":\"X\",\"ts\":{:.3f},\"dur\":{:.3f},\"pid\":1,\"tid\":{}", event.start_ns / 1000.0,
+                        event.duration_ns / 1000.0, buffer->tid);
+
+                    if (event.arg_name != nullptr) {
+                        out += ",\"args\":{";
+                        append_json_string(out, event.arg_name);
+                        fmt::format_to(std::back_inserter(out), ":{}}}", event.arg);
+                    }
+
+                    out += '}';
+                    ++num_events;
+                }
+            }
+        }
+    }
+
+    out += "\n]}\n";
+
+    std::ofstream f{path, std::ios::binary};
+    f << out;
+
+    if (!f) {
+        spdlog::error("Failed to write trace to {}", path.string());
+        return 0;
+    }
+
+    spdlog::info("Wrote {} trace events to {}", num_events, path.string());
+    return num_events;
+}
+
+Trace::ThreadBuffer& Trace::thread_buffer() {
+    thread_local ThreadBuffer* t_buffer{};
+
+    if (t_buffer == nullptr) {
+        std::scoped_lock _{m_buffers_lock};
+        auto& buffer = m_buffers.emplace_back(std::make_unique<ThreadBuffer>());
+
+        buffer->tid = (uint32_t)m_buffers.size();
+        t_buffer = buffer.get();
+    }
+
+    return *t_buffer;
+}
+
+void Trace::record(const Event& event, uint32_t session) {
+    // Scopes that began in a previous session are dropped.
+    if (session != s_session.load(std::memory_order_acquire)) {
+        return;
+    }
+
+    auto& buffer = thread_buffer();
+
+    if (buffer.session.load(std::memory_order_relaxed) != session) {
+        buffer.head.store(nullptr, std::memory_order_relaxed);
+        buffer.tail = nullptr;
+        buffer.num_events = 0;
+        buffer.chunks.clear();
+        buffer.session.store(session, std::memory_order_release);
+    }
+
+    if (buffer.num_events >= max_events_per_thread) {
+        return;
+    }
+
+    if (buffer.tail == nullptr || buffer.tail->count.load(std::memory_order_relaxed) == chunk_size) {
+        auto chunk = buffer.chunks.emplace_back(std::make_unique<Chunk>()).get();
+
+        if (buffer.tail == nullptr) {
+            buffer.head.store(chunk, std::memory_order_release);
+        } else {
+            buffer.tail->next.store(chunk, std::memory_order_release);
+        }
+
+        buffer.tail = chunk;
+    }
+
+    auto count = buffer.tail->count.load(std::memory_order_relaxed);
+
+    buffer.tail->events[count] = event;
+    buffer.tail->count.store(count + 1, std::memory_order_release);
+    ++buffer.num_events;
+}
+
+int64_t Trace::now_ns() const {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - m_epoch).count();
+}
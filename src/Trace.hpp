@@ -0,0 +1,111 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// Records what ReGenny spends its time on as Chrome trace events (open the saved file in chrome://tracing or
+// ui.perfetto.dev). Scopes are instrumented with TRACE_SCOPE and cost a single relaxed load while tracing is off.
+//
+// Every thread appends to its own buffer so recording never takes a lock. Buffers are made of fixed size chunks that
+// are only appended to, with the number of events published by the owning thread, so stop() can read them while other
+// threads keep recording.
+class Trace {
+public:
+    struct Event {
+        // Both must be string literals (or otherwise outlive the session).
+        const char* name{};
+        const char* category{};
+        int64_t start_ns{};
+        int64_t duration_ns{};
+        // Optional numeric argument shown in the event's details.
+        const char* arg_name{};
+        int64_t arg{};
+    };
+
+    class Scope {
+    public:
+        Scope(const char* name, const char* category) {
+            if (is_enabled()) {
+                begin(name, category);
+            }
+        }
+
+        ~Scope() {
+            if (m_session != 0) {
+                end();
+            }
+        }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+        void arg(const char* name, int64_t value) {
+            m_event.arg_name = name;
+            m_event.arg = value;
+        }
+
+    private:
+        Event m_event{};
+        uint32_t m_session{};
+
+        void begin(const char* name, const char* category);
+        void end();
+    };
+
+    static Trace& get();
+    static bool is_enabled() { return s_enabled.load(std::memory_order_relaxed); }
+    static void set_thread_name(const char* name);
+
+    // Starts a new session, dropping whatever was recorded before.
+    void start();
+    // Stops recording and writes the session to path. Returns the number of events written.
+    size_t stop(const std::filesystem::path& path);
+
+private:
+    static constexpr size_t chunk_size = 4096;
+    // Per thread cap so a forgotten session can't eat all the memory.
+    static constexpr size_t max_events_per_thread = 4 * 1024 * 1024;
+
+    struct Chunk {
+        Event events[chunk_size]{};
+        std::atomic<size_t> count{};
+        std::atomic<Chunk*> next{};
+    };
+
+    struct ThreadBuffer {
+        uint32_t tid{};
+        std::atomic<const char*> name{};
+        // Session the chunks belong to, published after head is reset for a new session.
+        std::atomic<uint32_t> session{};
+        std::atomic<Chunk*> head{};
+        // Only touched by the owning thread. The chunks of a session are freed once the thread records into the next
+        // one (stop() has finished reading them by then).
+        Chunk* tail{};
+        size_t num_events{};
+        std::vector<std::unique_ptr<Chunk>> chunks{};
+    };
+
+    static std::atomic<bool> s_enabled;
+    static std::atomic<uint32_t> s_session;
+
+    std::mutex m_buffers_lock{};
+    std::vector<std::unique_ptr<ThreadBuffer>> m_buffers{};
+    std::chrono::steady_clock::time_point m_epoch{std::chrono::steady_clock::now()};
+
+    Trace() = default;
+
+    ThreadBuffer& thread_buffer();
+    void record(const Event& event, uint32_t session);
+    int64_t now_ns() const;
+};
+
+#define TRACE_CONCAT_IMPL(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_IMPL(a, b)
+
+// Times the rest of the enclosing scope.
+#define TRACE_SCOPE(name, category) Trace::Scope TRACE_CONCAT(trace_scope_, __LINE__){name, category}
@@ -0,0 +1,477 @@
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <mutex>
+
+#include <fmt/format.h>
+#include <imgui.h>
+#include <imgui_stdlib.h>
+#include <ppl.h>
+#include <spdlog/spdlog.h>
+
+#include "Utility.hpp"
+
+#include "TypeSearchUi.hpp"
+
+using namespace std::literals;
+
+namespace {
+// Memory is swept in chunks of this size (each chunk is read in one go and searched on one thread).
+constexpr size_t chunk_size = 1024 * 1024;
+constexpr size_t max_results = 10000;
+
+const char* describe(const TypeSearchUi::Check& check) {
+    switch (check.kind) {
+    case TypeSearchUi::CheckKind::Vtable:
+        return "vtable";
+    case TypeSearchUi::CheckKind::Enum:
+        return "enum value";
+    case TypeSearchUi::CheckKind::Bool:
+        return "bool";
+    case TypeSearchUi::CheckKind::Pointer:
+        return check.nonnull ? "non-null pointer" : "pointer";
+    case TypeSearchUi::CheckKind::Range:
+        return "range";
+    case TypeSearchUi::CheckKind::Float:
+    case TypeSearchUi::CheckKind::Double:
+        return check.has_range ? "float range" : "float";
+    default:
+        return "";
+    }
+}
+
+uint64_t mask_to(uint64_t value, size_t size) {
+    return size >= sizeof(uint64_t) ? value : value & ((1ull << (size * 8)) - 1);
+}
+
+template <typename T> bool plausible_float(const TypeSearchUi::Check& check, const std::byte* mem) {
+    T value{};
+    memcpy(&value, mem + check.offset, sizeof(T));
+
+    if (!std::isfinite(value)) {
+        return false;
+    }
+
+    if (check.has_range) {
+        return value >= check.min && value <= check.max;
+    }
+
+    // Pointers and most integers reinterpreted as floats end up tiny or huge.
+    auto magnitude = std::abs(value);
+    return value == 0 || (magnitude > 1e-10 && magnitude < 1e10);
+}
+} // namespace
+
+std::optional<uintptr_t> TypeSearchUi::ui(Process& process, sdkgenny::Struct* struct_) {
+    if (struct_ == nullptr || struct_->size() == 0) {
+        ImGui::Text("Error: No Type");
+        return std::nullopt;
+    }
+
+    auto searching = m_search.valid();
+
+    if ((m_struct != struct_ || m_pointer_size != process.pointer_size()) && !searching) {
+        m_struct = struct_;
+        m_pointer_size = process.pointer_size();
+        m_checks = compile(struct_, std::nullopt, m_pointer_size);
+        m_vtable_text.clear();
+        m_results.clear();
+    }
+
+    if (searching && m_search.wait_for(0s) == std::future_status::ready) {
+        try {
+            m_results = m_search.get();
+        } catch (const std::exception& e) {
+            spdlog::error("Type search failed: {}", e.what());
+        }
+
+        searching = false;
+    }
+
+    ImGui::BeginDisabled(searching);
+
+    if (ImGui::InputText("Vtable (optional)", &m_vtable_text)) {
+        std::optional<uintptr_t> vtable{};
+
+        try {
+            if (!m_vtable_text.empty()) {
+                vtable = std::stoull(m_vtable_text, nullptr, 16);
+            }
+        } catch (...) {
+        }
+
+        m_checks = compile(struct_, vtable, m_pointer_size);
+    }
+
+    ImGui::InputInt("Alignment", &m_alignment);
+    m_alignment = std::clamp(m_alignment, 1, 64);
+    ImGui::SliderFloat("Min score", &m_min_score, 0.0f, 1.0f, "%.2f");
+
+    if (ImGui::Button("Search") && !m_checks.empty()) {
+        start_search(process);
+        searching = true;
+    }
+
+    ImGui::EndDisabled();
+
+    if (searching) {
+        ImGui::SameLine();
+
+        if (ImGui::Button("Cancel")) {
+            m_cancel = true;
+        }
+
+        ImGui::ProgressBar(
+            m_progress, ImVec2{-1.0f, 0.0f}, fmt::format("Searching... {:.1f}%", m_progress * 100.0f).c_str());
+    }
+
+    if (m_checks.empty()) {
+        ImGui::TextDisabled("%s has no fields that can be checked", struct_->name().c_str());
+        return std::nullopt;
+    }
+
+    ImGui::Text("%zu checks, most selective first", m_checks.size());
+
+    if (ImGui::BeginTable("checks", 3, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_ScrollY,
+            ImVec2{0.0f, 160.0f})) {
+        ImGui::TableSetupScrollFreeze(0, 1);
+        ImGui::TableSetupColumn("Offset");
+        ImGui::TableSetupColumn("Field");
+        ImGui::TableSetupColumn("Check");
+        ImGui::TableHeadersRow();
+
+        for (auto&& check : m_checks) {
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            ImGui::Text("0x%zX", (size_t)check.offset);
+            ImGui::TableNextColumn();
+            ImGui::TextUnformatted(check.field_name.c_str());
+            ImGui::TableNextColumn();
+
+            if (check.has_range) {
+                ImGui::Text("%s [%g, %g]", describe(check), check.min, check.max);
+            } else {
+                ImGui::TextUnformatted(describe(check));
+            }
+        }
+
+        ImGui::EndTable();
+    }
+
+    std::optional<uintptr_t> picked{};
+
+    ImGui::Text("%zu results%s", m_results.size(), m_results.size() >= max_results ? " (limited)" : "");
+
+    if (ImGui::BeginTable("results", 2, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_ScrollY)) {
+        ImGui::TableSetupScrollFreeze(0, 1);
+        ImGui::TableSetupColumn("Score");
+        ImGui::TableSetupColumn("Address");
+        ImGui::TableHeadersRow();
+
+        ImGuiListClipper clipper{};
+        clipper.Begin((int)m_results.size());
+
+        while (clipper.Step()) {
+            for (auto i = clipper.DisplayStart; i < clipper.DisplayEnd; ++i) {
+                auto& result = m_results[i];
+
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn();
+                ImGui::Text("%zu/%zu", result.passed, m_checks.size());
+                ImGui::TableNextColumn();
+
+                if (ImGui::Selectable(fmt::format("0x{:X}", result.address).c_str(), false,
+                        ImGuiSelectableFlags_SpanAllColumns)) {
+                    picked = result.address;
+                }
+            }
+        }
+
+        ImGui::EndTable();
+    }
+
+    return picked;
+}
+
+std::vector<TypeSearchUi::Check> TypeSearchUi::compile(
+    sdkgenny::Struct* struct_, std::optional<uintptr_t> vtable, size_t pointer_size) {
+    std::vector<std::pair<uintptr_t, sdkgenny::Variable*>> variables{};
+    collect_variables(struct_, 0, variables);
+
+    std::vector<Check> checks{};
+
+    if (vtable) {
+        Check check{.kind = CheckKind::Vtable, .offset = 0, .size = pointer_size, .field_name = "vtable"};
+        check.values.emplace_back(*vtable);
+        checks.emplace_back(std::move(check));
+    }
+
+    for (auto&& [offset, var] : variables) {
+        auto size = var->size();
+
+        if (var->is_bitfield() || size == 0 || size > sizeof(uint64_t) || offset + size > struct_->size()) {
+            continue;
+        }
+
+        // The vtable check replaces whatever the struct declares there.
+        if (vtable && offset < pointer_size) {
+            continue;
+        }
+
+        Check check{.offset = offset, .size = size, .field_name = var->name()};
+        std::optional<CheckKind> kind{};
+        std::array<std::vector<std::string>*, 2> metadatas{&var->metadata(), &var->type()->metadata()};
+
+        for (auto&& metadata : metadatas) {
+            for (auto&& md : *metadata) {
+                if (md == "nonnull") {
+                    check.nonnull = true;
+                } else if (md == "bool") {
+                    kind = CheckKind::Bool;
+                } else if (md == "f32" && size == sizeof(float)) {
+                    kind = CheckKind::Float;
+                } else if (md == "f64" && size == sizeof(double)) {
+                    kind = CheckKind::Double;
+                } else if (md == "i8" || md == "i16" || md == "i32" || md == "i64") {
+                    check.is_signed = true;
+                } else if (md.starts_with("range:")) {
+                    auto second_colon = md.find(':', 6);
+
+                    try {
+                        check.min = std::stod(md.substr(6, second_colon - 6));
+                        check.max = std::stod(md.substr(second_colon + 1));
+                        check.has_range = second_colon != std::string::npos;
+                    } catch (...) {
+                        spdlog::error("{}: bad range metadata {}", var->name(), md);
+                    }
+                }
+            }
+        }
+
+        if (auto enum_ = dynamic_cast<sdkgenny::Enum*>(var->type())) {
+            kind = CheckKind::Enum;
+
+            for (auto&& [name, value] : enum_->values()) {
+                check.values.emplace_back(mask_to((uint64_t)value, size));
+            }
+        } else if (var->type()->is_a<sdkgenny::Pointer>()) {
+            // sdkgenny lays pointers out at our size, only the target's pointer size of it is the pointer.
+            kind = CheckKind::Pointer;
+            check.size = pointer_size;
+        } else if (!kind && check.has_range) {
+            kind = CheckKind::Range;
+        }
+
+        if (!kind) {
+            continue;
+        }
+
+        check.kind = *kind;
+        checks.emplace_back(std::move(check));
+    }
+
+    // CheckKind is declared in roughly the order of how many random addresses each kind rejects.
+    std::stable_sort(checks.begin(), checks.end(), [](auto&& a, auto&& b) {
+        auto a_rank = (int)a.kind * 2 - (a.nonnull || a.has_range);
+        auto b_rank = (int)b.kind * 2 - (b.nonnull || b.has_range);
+        return a_rank < b_rank;
+    });
+
+    return checks;
+}
+
+void TypeSearchUi::start_search(Process& process) {
+    auto num_required = (size_t)std::ceil(m_min_score * m_checks.size());
+    auto max_failures = m_checks.size() - std::min(num_required, m_checks.size());
+
+    m_results.clear();
+    m_progress = 0.0f;
+    m_cancel = false;
+    m_search = std::async(std::launch::async, &TypeSearchUi::search, this, std::ref(process), m_checks,
+        m_struct->size(), (size_t)m_alignment, max_failures);
+}
+
+std::vector<TypeSearchUi::Candidate> TypeSearchUi::search(
+    Process& process, std::vector<Check> checks, size_t struct_size, size_t alignment, size_t max_failures) {
+    auto start_time = std::chrono::steady_clock::now();
+
+    // Where pointers are allowed to point.
+    std::vector<Range> valid_ranges{};
+
+    for (auto&& allocation : process.allocations()) {
+        valid_ranges.emplace_back(allocation.start, allocation.end);
+    }
+
+    for (auto&& module : process.modules()) {
+        valid_ranges.emplace_back(module.start, module.end);
+    }
+
+    std::sort(valid_ranges.begin(), valid_ranges.end(), [](auto&& a, auto&& b) { return a.start < b.start; });
+
+    // Modules overlap their allocations so merge everything into disjoint ranges for the binary search in passes.
+    std::vector<Range> merged{};
+
+    for (auto&& range : valid_ranges) {
+        if (!merged.empty() && range.start <= merged.back().end) {
+            merged.back().end = std::max(merged.back().end, range.end);
+        } else {
+            merged.emplace_back(range);
+        }
+    }
+
+    valid_ranges = std::move(merged);
+
+    // Instances of anything we'd search for live in writable memory.
+    std::vector<Range> chunks{};
+    size_t total_bytes{};
+
+    for (auto&& allocation : process.allocations()) {
+        if (!allocation.read || !allocation.write || allocation.end - allocation.start < struct_size) {
+            continue;
+        }
+
+        for (auto start = allocation.start; start < allocation.end; start += chunk_size) {
+            chunks.emplace_back(start, std::min(start + chunk_size, allocation.end));
+        }
+
+        total_bytes += allocation.end - allocation.start;
+    }
+
+    std::vector<Candidate> results{};
+    std::mutex results_lock{};
+    std::atomic<size_t> bytes_done{};
+    auto region_end = [&](uintptr_t address) {
+        for (auto&& allocation : process.allocations()) {
+            if (allocation.start <= address && address < allocation.end) {
+                return allocation.end;
+            }
+        }
+
+        return address;
+    };
+
+    concurrency::parallel_for(size_t{0}, chunks.size(), [&](size_t i) {
+        if (m_cancel) {
+            return;
+        }
+
+        ReadGovernor::PriorityScope priority{ReadGovernor::Priority::Scan, &m_cancel};
+
+        auto& chunk = chunks[i];
+
+        // Read a little past the chunk so instances straddling the next chunk are still seen whole.
+        auto read_end = std::min(chunk.end + struct_size - 1, region_end(chunk.start));
+        std::vector<std::byte> mem(read_end - chunk.start);
+        auto mask = process.read_partial(chunk.start, mem.data(), mem.size());
+        std::vector<Candidate> local{};
+
+        if (!mask.none()) {
+            process.with_pointer([&]<typename Ptr>(Ptr) {
+                auto first = (chunk.start + alignment - 1) / alignment * alignment;
+
+                for (auto address = first; address < chunk.end && address + struct_size <= read_end;
+                     address += alignment) {
+                    if (!mask.is_valid(address, struct_size)) {
+                        continue;
+                    }
+
+                    auto instance = &mem[address - chunk.start];
+                    size_t passed{};
+                    size_t failed{};
+
+                    for (auto&& check : checks) {
+                        if (passes<Ptr>(check, instance, valid_ranges)) {
+                            ++passed;
+                        } else if (++failed > max_failures) {
+                            break;
+                        }
+                    }
+
+                    if (failed <= max_failures) {
+                        local.emplace_back(address, passed);
+                    }
+                }
+            });
+        }
+
+        bytes_done += chunk.end - chunk.start;
+        m_progress = (float)bytes_done / (float)std::max<size_t>(total_bytes, 1);
+
+        if (!local.empty()) {
+            std::scoped_lock _{results_lock};
+            results.insert(results.end(), local.begin(), local.end());
+        }
+    });
+
+    std::sort(results.begin(), results.end(), [](auto&& a, auto&& b) {
+        return a.passed != b.passed ? a.passed > b.passed : a.address < b.address;
+    });
+
+    spdlog::info("Type search found {} candidates in {:.1f}MiB in {:.1f}s{}", results.size(),
+        total_bytes / (1024.0 * 1024.0),
+        std::chrono::duration<double>{std::chrono::steady_clock::now() - start_time}.count(),
+        m_cancel ? " (cancelled)" : "");
+
+    if (results.size() > max_results) {
+        results.resize(max_results);
+    }
+
+    return results;
+}
+
+template <typename Ptr>
+bool TypeSearchUi::passes(const Check& check, const std::byte* mem, const std::vector<Range>& valid_ranges) {
+    uint64_t raw{};
+
+    // Vtable and pointer checks are always pointer sized (see compile).
+    if (check.kind == CheckKind::Vtable || check.kind == CheckKind::Pointer) {
+        raw = Ptr::load(mem + check.offset);
+    } else {
+        memcpy(&raw, mem + check.offset, check.size);
+    }
+
+    switch (check.kind) {
+    case CheckKind::Vtable:
+        return raw == check.values.front();
+
+    case CheckKind::Enum:
+        return std::find(check.values.begin(), check.values.end(), raw) != check.values.end();
+
+    case CheckKind::Bool:
+        return raw <= 1;
+
+    case CheckKind::Pointer: {
+        if (raw == 0) {
+            return !check.nonnull;
+        }
+
+        auto it = std::upper_bound(valid_ranges.begin(), valid_ranges.end(), (uintptr_t)raw,
+            [](uintptr_t address, const Range& range) { return address < range.start; });
+
+        return it != valid_ranges.begin() && (uintptr_t)raw < std::prev(it)->end;
+    }
+
+    case CheckKind::Range: {
+        double value{};
+
+        if (check.is_signed) {
+            // Sign extend from the field's size.
+            auto shift = (sizeof(uint64_t) - check.size) * 8;
+            value = (double)((int64_t)(raw << shift) >> shift);
+        } else {
+            value = (double)raw;
+        }
+
+        return value >= check.min && value <= check.max;
+    }
+
+    case CheckKind::Float:
+        return plausible_float<float>(check, mem);
+
+    case CheckKind::Double:
+        return plausible_float<double>(check, mem);
+
+    default:
+        return false;
+    }
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <future>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <sdkgenny.hpp>
+
+#include "Process.hpp"
+
+// Finds instances of a struct without RTTI by sweeping writable memory for places where its fields hold plausible
+// values. Every field the struct declares becomes a check:
+//
+//  - pointers must be null or point into known memory ([[nonnull]] also rejects null)
+//  - floats must be finite and of a sane magnitude, enums one of their declared values and bools 0 or 1
+//  - [[range:lo:hi]] constrains any number to [lo, hi]
+//  - a vtable address can be given to check the first pointer against
+//
+// Candidates are ranked by the fraction of checks they pass. The checks are ordered most selective first so most
+// addresses are rejected after a check or two.
+class TypeSearchUi {
+public:
+    enum class CheckKind {
+        Vtable,
+        Enum,
+        Bool,
+        Pointer,
+        Range,
+        Float,
+        Double
+    };
+
+    struct Check {
+        CheckKind kind{};
+        uintptr_t offset{};
+        size_t size{};
+        std::string field_name{};
+        bool nonnull{};
+        bool is_signed{};
+        bool has_range{};
+        double min{};
+        double max{};
+        std::vector<uint64_t> values{};
+    };
+
+    struct Candidate {
+        uintptr_t address{};
+        size_t passed{};
+    };
+
+    ~TypeSearchUi() { cancel(); }
+
+    // Stops a search that's running and waits for it (call before the process it's searching goes away).
+    void cancel() {
+        if (m_search.valid()) {
+            m_cancel = true;
+            m_search.wait();
+        }
+    }
+
+    // Returns the address of a result the user picked.
+    std::optional<uintptr_t> ui(Process& process, sdkgenny::Struct* struct_);
+
+    static std::vector<Check> compile(
+        sdkgenny::Struct* struct_, std::optional<uintptr_t> vtable, size_t pointer_size);
+
+private:
+    struct Range {
+        uintptr_t start{};
+        uintptr_t end{};
+    };
+
+    sdkgenny::Struct* m_struct{};
+    // Of the process the checks were compiled for.
+    size_t m_pointer_size{};
+    std::vector<Check> m_checks{};
+    std::string m_vtable_text{};
+    int m_alignment{8};
+    float m_min_score{1.0f};
+
+    std::future<std::vector<Candidate>> m_search{};
+    std::atomic<float> m_progress{};
+    std::atomic<bool> m_cancel{};
+    std::vector<Candidate> m_results{};
+
+    void start_search(Process& process);
+    std::vector<Candidate> search(Process& process, std::vector<Check> checks, size_t struct_size, size_t alignment,
+        size_t max_failures);
+    template <typename Ptr>
+    static bool passes(const Check& check, const std::byte* mem, const std::vector<Range>& valid_ranges);
+};
@@ -1,3 +1,5 @@
+#include <cctype>
+
 #include <tao/pegtl.hpp>
 
 #include "Utility.hpp"
@@ -45,3 +47,65 @@ std::optional<ParsedAddress> parse_address(const std::string& str) {
 
     return std::nullopt;
 }
+
+void collect_variables(
+    sdkgenny::Struct* struct_, uintptr_t offset, std::vector<std::pair<uintptr_t, sdkgenny::Variable*>>& variables) {
+    auto parent_offset = offset;
+
+    for (auto&& parent : struct_->parents()) {
+        collect_variables(parent, parent_offset, variables);
+        parent_offset += parent->size();
+    }
+
+    for (auto&& var : struct_->get_all<sdkgenny::Variable>()) {
+        variables.emplace_back(offset + var->offset(), var);
+    }
+}
+
+std::vector<std::string> split_scopes(const std::string& name) {
+    std::vector<std::string> scopes{};
+    std::string cur{};
+    int depth{};
+
+    for (size_t i = 0; i < name.size(); ++i) {
+        auto c = name[i];
+
+        if (c == '<' || c == '(') {
+            ++depth;
+        } else if (c == '>' || c == ')') {
+            --depth;
+        } else if (depth == 0 && c == ':' && i + 1 < name.size() && name[i + 1] == ':') {
+            scopes.emplace_back(std::move(cur));
+            cur.clear();
+            ++i;
+            continue;
+        }
+
+        cur += c;
+    }
+
+    scopes.emplace_back(std::move(cur));
+    return scopes;
+}
+
+std::string to_identifier(const std::string& scope) {
+    std::string out{};
+
+    for (auto c : scope) {
+        if (std::isalnum((unsigned char)c) || c == '_') {
+            out += c;
+        } else if (!out.empty() && out.back() != '_') {
+            out += '_';
+        }
+    }
+
+    while (!out.empty() && out.back() == '_') {
+        out.pop_back();
+    }
+
+    if (out.empty() || std::isdigit((unsigned char)out.front())) {
+        out.insert(out.begin(), '_');
+    }
+
+    return out;
+}
@@ -5,9 +5,22 @@
 #include <string>
 #include <vector>
 
+#include <sdkgenny.hpp>
+
 struct ParsedAddress {
     std::string name{};
     std::vector<uintptr_t> offsets{};
 };
 
-std::optional<ParsedAddress> parse_address(const std::string& str);
\ No newline at end of file
+std::optional<ParsedAddress> parse_address(const std::string& str);
+
+// Collects every variable of struct_ (including the ones in its parents) along with its offset from the start of
+// struct_.
+void collect_variables(
+    sdkgenny::Struct* struct_, uintptr_t offset, std::vector<std::pair<uintptr_t, sdkgenny::Variable*>>& variables);
+
+// Splits "a::b<c::d>::e" into {"a", "b<c::d>", "e"}.
+std::vector<std::string> split_scopes(const std::string& name);
+
+// Turns a C++ scope (which may contain template arguments or `anonymous namespace') into a genny identifier.
+std::string to_identifier(const std::string& scope);
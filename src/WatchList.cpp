@@ -0,0 +1,314 @@
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstring>
+
+#include <spdlog/spdlog.h>
+
+#include "WatchList.hpp"
+
+template <typename T> static double load_as_double(const std::vector<std::byte>& bytes) {
+    T value{};
+    memcpy(&value, bytes.data(), std::min(sizeof(T), bytes.size()));
+    return (double)value;
+}
+
+double WatchList::Watch::number(const std::vector<std::byte>& bytes) const {
+    switch (kind) {
+    case Kind::U8:
+        return load_as_double<uint8_t>(bytes);
+    case Kind::U16:
+        return load_as_double<uint16_t>(bytes);
+    case Kind::U32:
+        return load_as_double<uint32_t>(bytes);
+    case Kind::U64:
+        return load_as_double<uint64_t>(bytes);
+    case Kind::I8:
+        return load_as_double<int8_t>(bytes);
+    case Kind::I16:
+        return load_as_double<int16_t>(bytes);
+    case Kind::I32:
+        return load_as_double<int32_t>(bytes);
+    case Kind::I64:
+        return load_as_double<int64_t>(bytes);
+    case Kind::F32:
+        return load_as_double<float>(bytes);
+    case Kind::F64:
+        return load_as_double<double>(bytes);
+    case Kind::Bool:
+        return load_as_double<bool>(bytes);
+    default:
+        return 0.0;
+    }
+}
+
+std::optional<WatchList::Kind> WatchList::parse_kind(std::string_view name) {
+    constexpr std::pair<std::string_view, Kind> kinds[]{
+        {"u8", Kind::U8},
+        {"u16", Kind::U16},
+        {"u32", Kind::U32},
+        {"u64", Kind::U64},
+        {"i8", Kind::I8},
+        {"i16", Kind::I16},
+        {"i32", Kind::I32},
+        {"i64", Kind::I64},
+        {"f32", Kind::F32},
+        {"f64", Kind::F64},
+        {"bool", Kind::Bool},
+    };
+
+    for (auto&& [kind_name, kind] : kinds) {
+        if (kind_name == name) {
+            return kind;
+        }
+    }
+
+    return std::nullopt;
+}
+
+size_t WatchList::kind_size(Kind kind) {
+    switch (kind) {
+    case Kind::U8:
+    case Kind::I8:
+    case Kind::Bool:
+        return 1;
+    case Kind::U16:
+    case Kind::I16:
+        return 2;
+    case Kind::U32:
+    case Kind::I32:
+    case Kind::F32:
+        return 4;
+    case Kind::U64:
+    case Kind::I64:
+    case Kind::F64:
+        return 8;
+    default:
+        return 0;
+    }
+}
+
+uint32_t WatchList::add(ParsedAddress address, Kind kind, size_t size, Options options, Callback callback) {
+    auto watch = std::make_unique<Watch>();
+
+    watch->id = m_next_id++;
+    watch->address = std::move(address);
+    watch->kind = kind;
+    watch->size = kind == Kind::Bytes ? size : kind_size(kind);
+    watch->options = options;
+    watch->callback = std::move(callback);
+    watch->value.resize(watch->size);
+
+    auto id = watch->id;
+    m_watches.emplace_back(std::move(watch));
+
+    return id;
+}
+
+bool WatchList::remove(uint32_t id) {
+    auto it = std::find_if(m_watches.begin(), m_watches.end(), [id](auto&& watch) { return watch->id == id; });
+
+    if (it == m_watches.end() || (*it)->removed) {
+        return false;
+    }
+
+    // Callbacks can remove watches (including their own) so just flag it and erase it once we're done iterating.
+    if (m_is_updating) {
+        (*it)->removed = true;
+    } else {
+        m_watches.erase(it);
+    }
+
+    return true;
+}
+
+void WatchList::clear() {
+    if (!m_is_updating) {
+        m_watches.clear();
+        return;
+    }
+
+    for (auto&& watch : m_watches) {
+        watch->removed = true;
+    }
+}
+
+void WatchList::update(Process& process) {
+    if (m_watches.empty()) {
+        return;
+    }
+
+    auto now = std::chrono::steady_clock::now();
+    std::vector<Watch*> due{};
+
+    for (auto&& watch : m_watches) {
+        if (now >= watch->next_read_time) {
+            watch->next_read_time = now + watch->options.interval;
+            due.emplace_back(watch.get());
+        }
+    }
+
+    if (due.empty()) {
+        return;
+    }
+
+    // Watch reads (and whatever the callbacks read) yield to the UI when reads are being throttled. This runs on the UI
+    // thread so they never wait on the governor either, reads it would have to wait for fail and the watch is read
+    // again next interval.
+    static const std::atomic<bool> never_wait{true};
+    ReadGovernor::PriorityScope priority{ReadGovernor::Priority::Watch, &never_wait};
+
+    resolve_addresses(process, due);
+
+    std::vector<Process::ReadRequest> requests(due.size());
+
+    for (size_t i = 0; i < due.size(); ++i) {
+        requests[i].address = due[i]->resolved_address;
+        requests[i].buffer = due[i]->value.data();
+        requests[i].size = due[i]->size;
+    }
+
+    process.read_batch(requests);
+
+    m_is_updating = true;
+
+    for (size_t i = 0; i < due.size(); ++i) {
+        auto watch = due[i];
+
+        if (watch->removed || !requests[i].ok || watch->resolved_address == 0) {
+            continue;
+        }
+
+        if (!watch->has_reported && !watch->options.initial) {
+            watch->reported = watch->value;
+            watch->has_reported = true;
+            continue;
+        }
+
+        if (!should_fire(*watch)) {
+            continue;
+        }
+
+        if (now < watch->next_callback_time) {
+            // Rate limited. The change is still pending so it gets reported once the cooldown is over.
+            watch->next_read_time = std::min(watch->next_read_time, watch->next_callback_time);
+            continue;
+        }
+
+        auto keep = true;
+
+        try {
+            keep = watch->callback(*watch);
+        } catch (const std::exception& e) {
+            spdlog::error("Watch {} callback failed, removing it: {}", watch->id, e.what());
+            keep = false;
+        }
+
+        watch->reported = watch->value;
+        watch->has_reported = true;
+        watch->next_callback_time = now + watch->options.cooldown;
+
+        if (!keep) {
+            watch->removed = true;
+        }
+    }
+
+    m_is_updating = false;
+
+    std::erase_if(m_watches, [](auto&& watch) { return watch->removed; });
+}
+
+void WatchList::resolve_addresses(Process& process, std::vector<Watch*>& due) {
+    // Module names are resolved once per update no matter how many watches use them.
+    std::vector<std::pair<std::string, uintptr_t>> module_bases{};
+    size_t max_depth{};
+
+    for (auto&& watch : due) {
+        auto& parsed = watch->address;
+
+        watch->resolved_address = parsed.offsets.empty() ? 0 : parsed.offsets.front();
+        max_depth = std::max(max_depth, parsed.offsets.size());
+
+        if (parsed.name.empty() || parsed.offsets.empty()) {
+            continue;
+        }
+
+        auto it = std::find_if(module_bases.begin(), module_bases.end(),
+            [&](auto&& module_base) { return module_base.first == parsed.name; });
+
+        if (it == module_bases.end()) {
+            auto modname = parsed.name;
+            std::transform(modname.begin(), modname.end(), modname.begin(), tolower);
+            uintptr_t base{};
+
+            for (auto&& mod : process.modules()) {
+                std::string name = mod.name;
+                std::transform(name.begin(), name.end(), name.begin(), tolower);
+
+                if (name.ends_with(modname)) {
+                    base = mod.start;
+                    break;
+                }
+            }
+
+            it = module_bases.emplace(module_bases.end(), parsed.name, base);
+        }
+
+        // An unknown module makes the whole expression invalid.
+        watch->resolved_address = it->second == 0 ? 0 : watch->resolved_address + it->second;
+    }
+
+    // Dereference pointer chains one level at a time so every watch at the same depth shares a batch.
+    std::vector<Process::ReadRequest> requests{};
+    std::vector<Watch*> watches{};
+    std::vector<uintptr_t> pointers{};
+
+    for (size_t depth = 1; depth < max_depth; ++depth) {
+        requests.clear();
+        watches.clear();
+
+        for (auto&& watch : due) {
+            if (depth < watch->address.offsets.size() && watch->resolved_address != 0) {
+                watches.emplace_back(watch);
+            }
+        }
+
+        pointers.assign(watches.size(), 0);
+
+        for (size_t i = 0; i < watches.size(); ++i) {
+            requests.emplace_back(Process::ReadRequest{
+                .address = watches[i]->resolved_address, .buffer = &pointers[i], .size = process.pointer_size()});
+        }
+
+        process.read_batch(requests);
+
+        for (size_t i = 0; i < watches.size(); ++i) {
+            auto pointer = requests[i].ok ? process.load_pointer(&pointers[i]) : 0;
+            watches[i]->resolved_address = pointer == 0 ? 0 : pointer + watches[i]->address.offsets[depth];
+        }
+    }
+}
+
+bool WatchList::should_fire(const Watch& watch) const {
+    if (!watch.has_reported) {
+        return true;
+    }
+
+    if (watch.value == watch.reported) {
+        return false;
+    }
+
+    if (watch.kind == Kind::Bytes) {
+        return true;
+    }
+
+    auto value = watch.number(watch.value);
+    auto reported = watch.number(watch.reported);
+
+    if (watch.options.threshold) {
+        auto threshold = *watch.options.threshold;
+        return (reported < threshold) != (value < threshold);
+    }
+
+    return std::abs(value - reported) >= watch.options.min_delta;
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+#include "Process.hpp"
+#include "Utility.hpp"
+
+// Change notifications for values in the process. Every watch that is due on a tick is resolved and read in batches
+// (one batch per pointer dereference level plus one for the values themselves) so hundreds of watches cost a handful
+// of reads, and callbacks only fire when a value actually changes.
+class WatchList {
+public:
+    enum class Kind {
+        U8,
+        U16,
+        U32,
+        U64,
+        I8,
+        I16,
+        I32,
+        I64,
+        F32,
+        F64,
+        Bool,
+        Bytes
+    };
+
+    struct Options {
+        // How often the value is read.
+        std::chrono::milliseconds interval{100};
+        // Numeric changes smaller than this are ignored.
+        double min_delta{};
+        // When set, only fire when the value crosses this threshold (in either direction).
+        std::optional<double> threshold{};
+        // Minimum time between two callbacks of the same watch. Changes during the cooldown are coalesced into the
+        // next callback.
+        std::chrono::milliseconds cooldown{};
+        // Fire for the first value read as well instead of only using it as the baseline.
+        bool initial{};
+    };
+
+    struct Watch;
+
+    // Called with the watch whose value changed. Return false to remove the watch.
+    using Callback = std::function<bool(const Watch& watch)>;
+
+    struct Watch {
+        uint32_t id{};
+        ParsedAddress address{};
+        Kind kind{};
+        size_t size{};
+        Options options{};
+        Callback callback{};
+
+        uintptr_t resolved_address{};
+        std::vector<std::byte> value{};
+        // The value that was last reported to the callback.
+        std::vector<std::byte> reported{};
+        bool has_reported{};
+        std::chrono::steady_clock::time_point next_read_time{};
+        std::chrono::steady_clock::time_point next_callback_time{};
+        bool removed{};
+
+        double number(const std::vector<std::byte>& bytes) const;
+    };
+
+    // Parses type names like "u32" or "f32" (the same names the memory view uses for metadata). Any other number of
+    // bytes can be watched as Kind::Bytes.
+    static std::optional<Kind> parse_kind(std::string_view name);
+    static size_t kind_size(Kind kind);
+
+    uint32_t add(ParsedAddress address, Kind kind, size_t size, Options options, Callback callback);
+    bool remove(uint32_t id);
+    void clear();
+    auto size() const { return m_watches.size(); }
+
+    // Reads the watches that are due and fires the callbacks of the ones that changed.
+    void update(Process& process);
+
+private:
+    // Watches are heap allocated so callbacks can add and remove watches while we're iterating.
+    std::vector<std::unique_ptr<Watch>> m_watches{};
+    uint32_t m_next_id{1};
+    bool m_is_updating{};
+
+    void resolve_addresses(Process& process, std::vector<Watch*>& due);
+    bool should_fire(const Watch& watch) const;
+};
@@ -1,13 +1,22 @@
+#include <algorithm>
+#include <cstring>
 #include <limits>
 
 #include <sstream>
+#include <unordered_map>
+#include <unordered_set>
 
 #include <Windows.h>
 
+#include <Psapi.h>
 #include <TlHelp32.h>
 
+#include "Trace.hpp"
+
 #include "Windows.hpp"
 
+using namespace std::literals;
+
 namespace arch {
 WindowsProcess::WindowsProcess(DWORD process_id) : Process{} {
     m_process = OpenProcess(
@@ -17,8 +26,13 @@ WindowsProcess::WindowsProcess(DWORD process_id) : Process{} {
         return;
     }
 
-    // Iterate modules.
-    auto snapshot = CreateToolhelp32Snapshot(TH32CS_SNAPMODULE, process_id);
+    // 32-bit processes running under WoW64 store 4 byte pointers.
+    if (BOOL wow64{}; IsWow64Process(m_process, &wow64) && wow64) {
+        m_pointer_size = 4;
+    }
+
+    // Iterate modules. SNAPMODULE32 is needed to see the modules of a WoW64 process.
+    auto snapshot = CreateToolhelp32Snapshot(TH32CS_SNAPMODULE | TH32CS_SNAPMODULE32, process_id);
 
     if (snapshot != INVALID_HANDLE_VALUE) {
         MODULEENTRY32 entry{};
@@ -42,6 +56,8 @@ WindowsProcess::WindowsProcess(DWORD process_id) : Process{} {
         CloseHandle(snapshot);
     }
 
+    map_module_images();
+
     // Iterate memory.
     uintptr_t address = 0;
     MEMORY_BASIC_INFORMATION mbi{};
@@ -70,10 +86,21 @@ WindowsProcess::WindowsProcess(DWORD process_id) : Process{} {
                 ro.read = a.read;
                 ro.write = a.write;
                 ro.execute = a.execute;
-                ro.mem.resize(ro.size);
 
-                if (read(ro.start, ro.mem.data(), ro.size)) {
-                    m_read_only_allocations.emplace_back(std::move(ro));
+                // Clean pages of a module can be read from our own copy of it without touching the process at all.
+                auto image = m_images.find((uintptr_t)mbi.AllocationBase);
+                auto mapped = image != m_images.end() ? image->second + (ro.start - image->first) : nullptr;
+
+                if (mbi.Type == MEM_IMAGE && mapped != nullptr && is_unmodified_image(ro.start, ro.size) &&
+                    matches_image(ro.start, ro.size, mapped)) {
+                    ro.mapped = mapped;
+                    cache_read_only_allocation(std::move(ro));
+                } else {
+                    ro.mem.resize(ro.size);
+
+                    if (read(ro.start, ro.mem.data(), ro.size)) {
+                        cache_read_only_allocation(std::move(ro));
+                    }
                 }
             }
 
@@ -84,6 +111,100 @@ WindowsProcess::WindowsProcess(DWORD process_id) : Process{} {
     }
 }
 
+WindowsProcess::~WindowsProcess() {
+    for (auto view : m_image_views) {
+        UnmapViewOfFile(view);
+    }
+}
+
+void WindowsProcess::map_module_images() {
+    for (auto&& module : m_modules) {
+        // Modules we have loaded at the same address (mostly system DLLs) can be used as they are, as long as the pages
+        // used match (see matches_image).
+        if (auto loaded = GetModuleHandleA(module.name.c_str()); loaded != nullptr) {
+            if ((uintptr_t)loaded == module.start) {
+                m_images[module.start] = (const std::byte*)loaded;
+            }
+
+            continue;
+        }
+
+        // Otherwise map the file as an image so its sections are laid out like they are in memory. Mapping it at the
+        // same address gets it relocated the same way, so pointers in its read-only data (vtables, jump tables) match.
+        auto file = CreateFileA(module.name.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr,
+            OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+        if (file == INVALID_HANDLE_VALUE) {
+            continue;
+        }
+
+        auto mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY | SEC_IMAGE, 0, 0, nullptr);
+
+        CloseHandle(file);
+
+        if (mapping == nullptr) {
+            continue;
+        }
+
+        // Fails if something of ours is already at that address, in which case the module is read normally.
+        auto view = MapViewOfFileEx(mapping, FILE_MAP_READ, 0, 0, 0, (LPVOID)module.start);
+
+        CloseHandle(mapping);
+
+        if (view == nullptr) {
+            continue;
+        }
+
+        // The file could have been replaced since the process loaded it.
+        std::array<std::byte, page_size> headers{};
+
+        if (!handle_read(module.start, headers.data(), headers.size()) ||
+            memcmp(headers.data(), view, headers.size()) != 0) {
+            UnmapViewOfFile(view);
+            continue;
+        }
+
+        m_image_views.emplace_back(view);
+        m_images[module.start] = (const std::byte*)view;
+    }
+}
+
+bool WindowsProcess::matches_image(uintptr_t start, size_t size, const std::byte* mapped) {
+    // The headers matching doesn't mean the rest does: our own copy of a module may be hooked, have its imports patched
+    // or have been relocated differently, and the target's may have been patched before we started. Any page of the
+    // region can differ so all of it is compared against the target, once, a chunk at a time.
+    constexpr size_t chunk_size = 64 * 1024;
+    std::vector<std::byte> chunk(std::min(size, chunk_size));
+
+    for (size_t offset = 0; offset < size; offset += chunk.size()) {
+        auto n = std::min(chunk.size(), size - offset);
+
+        if (!handle_read(start + offset, chunk.data(), n) || memcmp(chunk.data(), mapped + offset, n) != 0) {
+            return false;
+        }
+    }
+
+    return size != 0;
+}
+
+bool WindowsProcess::is_unmodified_image(uintptr_t start, size_t size) {
+    // Image pages the process has written to (hooks, patches) become private copies, so a resident page that's no
+    // longer shared differs from the file. Private copies that have been paged out can't be told apart from clean
+    // pages this way, but code that gets patched is usually hot enough to stay resident.
+    std::vector<PSAPI_WORKING_SET_EX_INFORMATION> pages(size / page_size);
+
+    for (size_t i = 0; i < pages.size(); ++i) {
+        pages[i].VirtualAddress = (PVOID)(start + i * page_size);
+    }
+
+    if (!QueryWorkingSetEx(m_process, pages.data(), (DWORD)(pages.size() * sizeof(pages[0])))) {
+        return false;
+    }
+
+    return std::none_of(pages.begin(), pages.end(),
+        [](auto&& page) { return page.VirtualAttributes.Valid && !page.VirtualAttributes.Shared; });
+}
+
 uint32_t WindowsProcess::process_id() {
     return GetProcessId(m_process);
 }
@@ -100,6 +221,18 @@ bool WindowsProcess::ok() {
     return exitcode == STILL_ACTIVE;
 }
 
+std::optional<std::chrono::nanoseconds> WindowsProcess::cpu_time() {
+    FILETIME creation{}, exit{}, kernel{}, user{};
+
+    if (!GetProcessTimes(m_process, &creation, &exit, &kernel, &user)) {
+        return std::nullopt;
+    }
+
+    auto to_100ns = [](const FILETIME& ft) { return ((uint64_t)ft.dwHighDateTime << 32) | ft.dwLowDateTime; };
+
+    return std::chrono::nanoseconds{(to_100ns(kernel) + to_100ns(user)) * 100};
+}
+
 bool WindowsProcess::handle_write(uintptr_t address, const void* buffer, size_t size) {
     SIZE_T bytes_written{};
 
@@ -111,18 +244,10 @@ bool WindowsProcess::handle_write(uintptr_t address, const void* buffer, size_t
 bool WindowsProcess::handle_read(uintptr_t address, void* buffer, size_t size) {
     SIZE_T bytes_read{};
 
+    // Reads that straddle an unreadable page fail here. Process::read_partial splits them up by page (and remembers the
+    // bad pages) so there's no need to query the region and retry.
     if (ReadProcessMemory(m_process, (LPCVOID)address, buffer, size, &bytes_read) == 0) {
-        // Query the page to get the real size, and re-read.
-        MEMORY_BASIC_INFORMATION mbi{};
-        if (VirtualQueryEx(m_process, (LPCVOID)address, &mbi, sizeof(mbi)) == 0) {
-            return false;
-        }
-
-        size = ((uintptr_t)mbi.BaseAddress + mbi.RegionSize) - address;
-
-        if (ReadProcessMemory(m_process, (LPCVOID)address, buffer, size, &bytes_read) == 0) {
-            return false;
-        }
+        return false;
     }
 
     return bytes_read == size;
@@ -275,8 +400,11 @@ std::optional<std::string> WindowsProcess::get_typename(uintptr_t ptr) {
     return get_typename_from_vtable(*vtable);
 }
 
-std::optional<std::string> WindowsProcess::get_typename_from_vtable(uintptr_t ptr) try {
-    if (ptr == 0) {
+std::optional<std::string> WindowsProcess::get_typename_from_vtable(uintptr_t ptr) {
+    TRACE_SCOPE("get_typename_from_vtable", "rtti");
+
+    // The RTTI structures are read with our own layout, which a 32-bit target doesn't share.
+    if (ptr == 0 || m_pointer_size != sizeof(uintptr_t)) {
         return std::nullopt;
     }
 
@@ -286,7 +414,156 @@ std::optional<std::string> WindowsProcess::get_typename_from_vtable(uintptr_t pt
         return std::nullopt;
     }
 
-    auto ti = (std::type_info*)&*typeinfo;
+    return undecorate_typeinfo(*typeinfo);
+}
+
+std::vector<Process::RttiClass> WindowsProcess::rtti_classes(const Module& module) {
+    TRACE_SCOPE("rtti_classes", "rtti");
+
+    if (m_pointer_size != sizeof(uintptr_t)) {
+        return {};
+    }
+
+#if _RTTI_RELATIVE_TYPEINFO
+    // Work on a copy of the whole image, everything RTTI refers to is an RVA into it.
+    std::vector<std::byte> image(module.size);
+    auto mask = read_partial(module.start, image.data(), image.size());
+
+    if (mask.none()) {
+        return {};
+    }
+
+    auto at = [&]<typename T>(uintptr_t rva, T& out) {
+        if (rva + sizeof(T) > image.size() || !mask.is_valid(module.start + rva, sizeof(T))) {
+            return false;
+        }
+
+        memcpy(&out, &image[rva], sizeof(T));
+        return true;
+    };
+
+    // Complete object locators point at themselves with pSelf. We only want the ones for complete objects (offset 0),
+    // the others belong to the vtables of secondary bases.
+    std::unordered_set<uintptr_t> locators{};
+
+    for (uintptr_t rva = 0; rva + sizeof(_s_RTTICompleteObjectLocator) <= image.size(); rva += sizeof(int)) {
+        _s_RTTICompleteObjectLocator locator{};
+
+        if (at(rva, locator) && locator.signature == COL_SIG_REV1 && locator.pSelf == (int)rva && locator.offset == 0) {
+            locators.emplace(module.start + rva);
+        }
+    }
+
+    std::vector<std::pair<uintptr_t, uintptr_t>> executable{};
+
+    for (auto&& allocation : m_allocations) {
+        if (allocation.execute && allocation.start >= module.start && allocation.end <= module.end) {
+            executable.emplace_back(allocation.start, allocation.end);
+        }
+    }
+
+    auto is_code = [&](uintptr_t address) {
+        return std::any_of(executable.begin(), executable.end(),
+            [&](auto&& range) { return range.first <= address && address < range.second; });
+    };
+
+    // Base classes are referenced by every class deriving from them so remember their names.
+    std::unordered_map<int, std::optional<std::string>> names{};
+
+    auto name_of = [&](int type_descriptor) -> const std::optional<std::string>& {
+        if (auto it = names.find(type_descriptor); it != names.end()) {
+            return it->second;
+        }
+
+        std::array<uint8_t, sizeof(std::type_info) + 256> typeinfo{};
+        auto available = std::min(typeinfo.size(), image.size() - std::min<size_t>(type_descriptor, image.size()));
+
+        if (type_descriptor <= 0 || available < sizeof(std::type_info) + 2) {
+            return names[type_descriptor] = std::nullopt;
+        }
+
+        memcpy(typeinfo.data(), &image[type_descriptor], available);
+        typeinfo.back() = 0;
+
+        auto name = undecorate_typeinfo(typeinfo);
+
+        for (auto prefix : {"class "sv, "struct "sv, "union "sv}) {
+            if (name && name->starts_with(prefix)) {
+                name->erase(0, prefix.size());
+            }
+        }
+
+        return names[type_descriptor] = name;
+    };
+
+    std::vector<RttiClass> classes{};
+
+    // A vtable is preceded by a pointer to its locator.
+    for (uintptr_t rva = 0; rva + 2 * sizeof(uintptr_t) <= image.size(); rva += sizeof(uintptr_t)) {
+        uintptr_t locator_ptr{};
+
+        if (!at(rva, locator_ptr) || !locators.contains(locator_ptr)) {
+            continue;
+        }
+
+        _s_RTTICompleteObjectLocator locator{};
+        _s_RTTIClassHierarchyDescriptor hierarchy{};
+
+        if (!at(locator_ptr - module.start, locator) || !at(locator.pClassDescriptor, hierarchy)) {
+            continue;
+        }
+
+        auto& name = name_of(locator.pTypeDescriptor);
+
+        if (!name) {
+            continue;
+        }
+
+        RttiClass c{};
+        c.name = *name;
+        c.vtable = module.start + rva + sizeof(uintptr_t);
+
+        for (uintptr_t slot = rva + sizeof(uintptr_t); slot + sizeof(uintptr_t) <= image.size();
+             slot += sizeof(uintptr_t)) {
+            uintptr_t fn{};
+
+            if (!at(slot, fn) || !is_code(fn)) {
+                break;
+            }
+
+            ++c.num_vfuncs;
+        }
+
+        // The base class array starts with the class itself followed by its bases in depth first order. Skipping each
+        // base's own bases leaves the direct bases.
+        for (DWORD i = 1; i < hierarchy.numBaseClasses;) {
+            int base_rva{};
+            _s_RTTIBaseClassDescriptor base{};
+
+            if (!at(hierarchy.pBaseClassArray + i * sizeof(int), base_rva) || !at(base_rva, base)) {
+                break;
+            }
+
+            if (auto& base_name = name_of(base.pTypeDescriptor)) {
+                c.parents.emplace_back(*base_name);
+            }
+
+            i += 1 + base.numContainedBases;
+        }
+
+        classes.emplace_back(std::move(c));
+    }
+
+    return classes;
+#else
+    // Only the x64 (image relative) RTTI layout is supported.
+    return {};
+#endif
+}
+
+std::optional<std::string> WindowsProcess::undecorate_typeinfo(
+    std::array<uint8_t, sizeof(std::type_info) + 256>& typeinfo) try {
+    auto ti = (std::type_info*)&typeinfo;
     if (ti->raw_name()[0] != '.' || ti->raw_name()[1] != '?') {
         return std::nullopt;
     }
@@ -332,8 +609,30 @@ std::map<uint32_t, std::string> WindowsHelpers::processes() {
     return pids;
 }
 
+std::optional<uint32_t> WindowsHelpers::memory_load() {
+    MEMORYSTATUSEX status{};
+
+    status.dwLength = sizeof(status);
+
+    if (GlobalMemoryStatusEx(&status) == 0) {
+        return std::nullopt;
+    }
+
+    return (uint32_t)status.dwMemoryLoad;
+}
+
+std::optional<size_t> WindowsHelpers::working_set() {
+    PROCESS_MEMORY_COUNTERS counters{};
+
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)) == 0) {
+        return std::nullopt;
+    }
+
+    return (size_t)counters.WorkingSetSize;
+}
+
 bool WindowsProcess::derives_from(uintptr_t obj_ptr, const std::string_view& type_name) {
-    if (obj_ptr == 0) {
+    if (obj_ptr == 0 || m_pointer_size != sizeof(uintptr_t)) {
         return false;
     }
 
@@ -451,7 +750,7 @@ bool WindowsProcess::derives_from(uintptr_t obj_ptr, const std::string_view& typ
 }
 
 bool WindowsProcess::derives_from(uintptr_t obj_ptr, const std::array<uint8_t, sizeof(std::type_info) + 256>& ti_compare) {
-    if (obj_ptr == 0) {
+    if (obj_ptr == 0 || m_pointer_size != sizeof(uintptr_t)) {
         return false;
     }
 
@@ -1,6 +1,8 @@
 #pragma once
 
 #include <array>
+#include <unordered_map>
+#include <vector>
 
 #include <Windows.h>
 #include <rttidata.h>
@@ -13,12 +15,15 @@ namespace arch {
 class WindowsProcess : public Process {
 public:
     WindowsProcess(DWORD process_id);
+    ~WindowsProcess() override;
 
     uint32_t process_id() override;
     bool ok() override;
+    std::optional<std::chrono::nanoseconds> cpu_time() override;
 
     std::optional<std::string> get_typename(uintptr_t ptr) override;
     std::optional<std::string> get_typename_from_vtable(uintptr_t ptr) override;
+    std::vector<RttiClass> rtti_classes(const Module& module) override;
 
     // RTTI
     std::optional<uintptr_t> get_complete_object_locator_ptr_from_vtable(uintptr_t vtable);
@@ -45,10 +50,22 @@ protected:
 
 private:
     HANDLE m_process{};
+
+    // Module start -> local copy of the module's image at the same address (see map_module_images).
+    std::unordered_map<uintptr_t, const std::byte*> m_images{};
+    std::vector<void*> m_image_views{};
+
+    void map_module_images();
+    bool matches_image(uintptr_t start, size_t size, const std::byte* mapped);
+    bool is_unmodified_image(uintptr_t start, size_t size);
+
+    static std::optional<std::string> undecorate_typeinfo(std::array<uint8_t, sizeof(std::type_info) + 256>& typeinfo);
 };
 
 class WindowsHelpers : public Helpers {
 public:
     std::map<uint32_t, std::string> processes() override;
+    std::optional<uint32_t> memory_load() override;
+    std::optional<size_t> working_set() override;
 };
 } // namespace arch
@@ -2,7 +2,7 @@
 #include <imgui.h>
 #include <utf8.h>
 
-#include "Pointer.hpp"
+#include "Factory.hpp"
 #include "Struct.hpp"
 
 #include "Array.hpp"
@@ -26,6 +26,8 @@ Array::Array(Config& cfg, Process& process, sdkgenny::Variable* var, Property& p
     : Variable{cfg, process, var, props}, m_arr{dynamic_cast<sdkgenny::Array*>(var->type())} {
     assert(m_arr != nullptr);
 
+    m_element_size = LayoutCache::size(m_arr->of());
+
     m_props["__collapsed"].set_default(true);
     m_props["__start"].set_default(0);
     m_props["__count"].set_default(std::min(10, (int)m_arr->count()));
@@ -73,17 +75,21 @@ void Array::display(uintptr_t address, uintptr_t offset, std::byte* mem) {
         ImGui::EndPopup();
     }
 
-    if (is_collapsed()) {
+    if (is_collapsed() && !is_forced_open()) {
         return;
     }
 
     auto start = start_element();
-    auto num_elements = num_elements_displayed();
+    auto num_elements = num_live_elements();
 
-    for (auto i = 0; i < num_elements; ++i) {
+    for (size_t i = 0; i < num_elements; ++i) {
         auto cur_element = start + i;
         auto& cur_node = m_elements[i];
-        auto cur_offset = cur_element * m_arr->of()->size();
+        auto cur_offset = cur_element * m_element_size;
+
+        if (!is_shown(cur_node.get())) {
+            continue;
+        }
 
         ++indentation_level;
         ImGui::PushID(cur_node.get());
@@ -93,20 +99,31 @@ void Array::display(uintptr_t address, uintptr_t offset, std::byte* mem) {
     }
 }
 
+void Array::fetch(uintptr_t address, std::byte* mem, const Process::PageMask* mask) {
+    Base::fetch(address, mem, mask);
+
+    auto start = start_element();
+
+    for (size_t i = 0; i < num_live_elements(); ++i) {
+        auto cur_offset = (start + i) * m_element_size;
+
+        m_elements[i]->fetch(address + cur_offset, mem + cur_offset, mask);
+    }
+}
+
 void Array::update(uintptr_t address, uintptr_t offset, std::byte* mem) {
     Base::update(address, offset, mem);
     m_value_str.clear();
 
-    auto num_elements = num_elements_displayed();
     auto start = start_element();
 
-    for (auto i = 0; i < num_elements; ++i) {
+    update_children(num_live_elements(), [&](size_t i) {
         auto cur_element = start + i;
         auto& cur_node = m_elements[i];
-        auto cur_offset = cur_element * m_arr->of()->size();
+        auto cur_offset = cur_element * m_element_size;
 
         cur_node->update(address + cur_offset, offset + cur_offset, mem + cur_offset);
-    }
+    });
 
     for (auto&& md : m_var->metadata()) {
         if (md == "utf8*") {
@@ -150,6 +167,29 @@ void Array::update(uintptr_t address, uintptr_t offset, std::byte* mem) {
     }
 }
 
+size_t Array::num_live_elements() const {
+    auto start = (size_t)m_props["__start"].as_int();
+
+    if (start >= m_limit) {
+        return 0;
+    }
+
+    return std::min(m_elements.size(), m_limit - start);
+}
+
+void Array::filter_text(std::vector<std::string_view>& out) {
+    Variable::filter_text(out);
+    out.emplace_back(m_value_str);
+}
+
+void Array::for_each_child(const std::function<void(Base&)>& fn) {
+    auto num_elements = num_live_elements();
+
+    for (size_t i = 0; i < num_elements; ++i) {
+        fn(*m_elements[i]);
+    }
+}
+
 void Array::create_nodes() {
     m_proxy_variables.clear();
     m_elements.clear();
@@ -157,6 +197,8 @@ void Array::create_nodes() {
     auto num_elements = num_elements_displayed();
     auto start = start_element();
     auto end = start + num_elements;
+    // Elements are all the same type without any metadata so they're all the same kind of node.
+    std::optional<NodeKind> kind{};
 
     for (auto i = start; i < end; ++i) {
         auto proxy_variable = std::make_unique<sdkgenny::Variable>(fmt::format("{}[{}]", m_var->name(), i));
@@ -165,18 +207,14 @@ void Array::create_nodes() {
         proxy_variable->type(m_arr->of());
         proxy_variable->offset(m_var->offset() + i * m_arr->size());
 
-        std::unique_ptr<Variable> node{};
+        if (!kind) {
+            kind = LayoutCache::classify(proxy_variable.get());
+        }
+
+        auto node = make_node(m_cfg, m_process, proxy_variable.get(), proxy_props, *kind);
 
-        if (proxy_variable->type()->is_a<sdkgenny::Array>()) {
-            node = std::make_unique<Array>(m_cfg, m_process, proxy_variable.get(), proxy_props);
-        } else if (proxy_variable->type()->is_a<sdkgenny::Struct>()) {
-            auto struct_ = std::make_unique<Struct>(m_cfg, m_process, proxy_variable.get(), proxy_props);
+        if (auto struct_ = dynamic_cast<Struct*>(node.get())) {
             struct_->is_collapsed(false);
-            node = std::move(struct_);
-        } else if (proxy_variable->type()->is_a<sdkgenny::Pointer>()) {
-            node = std::make_unique<Pointer>(m_cfg, m_process, proxy_variable.get(), proxy_props);
-        } else {
-            node = std::make_unique<Variable>(m_cfg, m_process, proxy_variable.get(), proxy_props);
         }
 
         m_proxy_variables.emplace_back(std::move(proxy_variable));
@@ -9,6 +9,9 @@ public:
 
     void display(uintptr_t address, uintptr_t offset, std::byte* mem) override;
     void update(uintptr_t address, uintptr_t offset, std::byte* mem) override;
+    void fetch(uintptr_t address, std::byte* mem, const Process::PageMask* mask) override;
+    void filter_text(std::vector<std::string_view>& out) override;
+    void for_each_child(const std::function<void(Base&)>& fn) override;
 
     auto is_collapsed(bool is_collapsed) {
         m_props["__collapsed"].set(is_collapsed);
@@ -16,6 +19,8 @@ public:
     }
     auto& is_collapsed() { return m_props["__collapsed"].as_bool(); }
 
+    void expand() override { is_collapsed() = false; }
+
     auto start_element(int start_element) {
         m_props["__start"].set(start_element);
         return this;
@@ -28,12 +33,19 @@ public:
     }
     auto& num_elements_displayed() { return m_props["__count"].as_int(); }
 
+    // Only the first count elements exist (the array type is a capacity), see Pointer's count binding.
+    void limit_elements(size_t count) { m_limit = count; }
+    // Number of the displayed elements that are within the limit.
+    size_t num_live_elements() const;
+
 protected:
     sdkgenny::Array* m_arr{};
+    size_t m_element_size{};
     std::vector<std::unique_ptr<Variable>> m_elements{};
     std::vector<std::unique_ptr<sdkgenny::Variable>> m_proxy_variables{};
 
     std::string m_value_str{};
+    size_t m_limit{SIZE_MAX};
 
     void create_nodes();
 
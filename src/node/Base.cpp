@@ -5,12 +5,26 @@
 // msvc 15 errors about min/max
 #include <algorithm>
 
+#include <ppl.h>
+
 #include "Base.hpp"
 
 namespace node {
 int Base::indentation_level = -1;
+const Base::Filter* Base::filter{};
+std::atomic<uint64_t> Base::structure_version{};
+const Process::PageMask Base::unreadable{};
 
 Base::Base(Config& cfg, Process& process, Property& props) : m_cfg{cfg}, m_process{process}, m_props{props} {
+    ++structure_version;
+}
+
+Base::~Base() {
+    ++structure_version;
+}
+
+void Base::fetch(uintptr_t address, std::byte* mem, const Process::PageMask* mask) {
+    m_readable = mask == nullptr || mask->is_valid(address, size());
 }
 
 void Base::update(uintptr_t address, uintptr_t offset, std::byte* mem) {
@@ -20,28 +34,35 @@ void Base::update(uintptr_t address, uintptr_t offset, std::byte* mem) {
 
     auto end = (int)std::min(size(), sizeof(uint64_t));
 
-    for (auto i = end - 1; i >= 0; --i) {
-        fmt::format_to(std::back_inserter(m_bytes_str), "{:02X}", *(uint8_t*)&mem[i]);
+    if (!m_readable) {
+        for (auto i = 0; i < end; ++i) {
+            m_bytes_str += "??";
+            m_print_str += '?';
+        }
+    } else {
+        for (auto i = end - 1; i >= 0; --i) {
+            fmt::format_to(std::back_inserter(m_bytes_str), "{:02X}", *(uint8_t*)&mem[i]);
+        }
+
+        for (auto i = 0; i < end; ++i) {
+            auto c = *(char*)(mem + i);
+
+            if (c >= 0 && isprint(c)) {
+                m_print_str += c;
+            } else {
+                m_print_str += '.';
+            }
+        }
     }
 
     if (end < size()) {
         m_bytes_str += "...";
     }
 
-    for (auto i = 0; i < end; ++i) {
-        auto c = *(char*)(mem + i);
-
-        if (c >= 0 && isprint(c)) {
-            m_print_str += c;
-        } else {
-            m_print_str += '.';
-        }
-    }
-
     auto needs_space = false;
 
     if (m_cfg.display_address) {
-        if constexpr (sizeof(void*) == 8) {
+        if (m_process.pointer_size() == 8) {
             fmt::format_to(std::back_inserter(m_preamble_str), "{:016X}", address);
         } else {
             fmt::format_to(std::back_inserter(m_preamble_str), "{:08X}", address);
@@ -78,7 +99,41 @@ void Base::update(uintptr_t address, uintptr_t offset, std::byte* mem) {
     }
 }
 
+void Base::update_children(size_t count, const std::function<void(size_t)>& update_child) {
+    if (count < parallel_update_threshold) {
+        for (size_t i = 0; i < count; ++i) {
+            update_child(i);
+        }
+
+        return;
+    }
+
+    auto num_chunks = (count + parallel_update_chunk_size - 1) / parallel_update_chunk_size;
+
+    concurrency::parallel_for(size_t{0}, num_chunks, [&](size_t chunk) {
+        auto start = chunk * parallel_update_chunk_size;
+        auto end = std::min(start + parallel_update_chunk_size, count);
+
+        for (auto i = start; i < end; ++i) {
+            update_child(i);
+        }
+    });
+}
+
 void Base::display_address_offset(uintptr_t address, uintptr_t offset) {
+    if (filter != nullptr && filter->matches.contains(this)) {
+        auto is_current = filter->current == this;
+        auto pos = ImGui::GetCursorScreenPos();
+        auto end = ImVec2{pos.x + ImGui::GetContentRegionAvail().x, pos.y + ImGui::GetTextLineHeight()};
+        auto color = is_current ? IM_COL32(90, 90, 30, 255) : IM_COL32(60, 60, 25, 255);
+
+        ImGui::GetWindowDrawList()->AddRectFilled(pos, end, color);
+
+        if (is_current && filter->scroll_to_current) {
+            ImGui::SetScrollHereY();
+        }
+    }
+
     ImGui::PushStyleColor(ImGuiCol_Text, {0.6f, 0.6f, 0.6f, 1.0f});
     ImGui::TextUnformatted(m_preamble_str.c_str());
     ImGui::PopStyleColor();
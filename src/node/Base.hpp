@@ -1,8 +1,13 @@
 #pragma once
 
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
+#include <functional>
+#include <string_view>
 #include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 #include "../Config.hpp"
 #include "../Process.hpp"
@@ -11,15 +16,49 @@
 namespace node {
 class Base {
 public:
+    // What MemoryUi's filter found, applied while displaying (see filter).
+    struct Filter {
+        std::unordered_set<const Base*> matches{};
+        // Nodes with a match somewhere beneath them.
+        std::unordered_set<const Base*> ancestors{};
+        // Hide everything that isn't a match or an ancestor of one (ancestors are displayed open).
+        bool only_matches{};
+        const Base* current{};
+        bool scroll_to_current{};
+    };
+
+    // Set for the duration of a MemoryUi::display.
+    static const Filter* filter;
+    // Changes whenever a node is created or destroyed, so the filter knows when the tree it walked is out of date.
+    static std::atomic<uint64_t> structure_version;
+
     Base(Config& cfg, Process& process, Property& props);
+    virtual ~Base();
 
     virtual void display(uintptr_t address, uintptr_t offset, std::byte* mem) = 0;
     virtual size_t size() = 0;
     virtual void update(uintptr_t address, uintptr_t offset, std::byte* mem);
+    // Reads whatever update needs from the process besides mem (eg. the string a pointer points to) and keeps it for
+    // update. Nodes fetch for their children too, so fetching the root of what's about to be updated does every read up
+    // front on the calling thread and update is left with nothing but formatting. mask is what came of reading mem
+    // (nullptr when all of it was read) and decides whether the node shows ??.
+    virtual void fetch(uintptr_t address, std::byte* mem, const Process::PageMask* mask);
+
+    // The strings last formatted for this node's row (name, type, value...) that the filter matches against. Nothing
+    // is read, so nodes that are collapsed (or scrolled away) match on what they showed last.
+    virtual void filter_text(std::vector<std::string_view>& out) {}
+    // Every child node that has been built, in display order.
+    virtual void for_each_child(const std::function<void(Base&)>& fn) {}
+    // Opens the node if it can be collapsed.
+    virtual void expand() {}
 
     auto& props() { return m_props; }
 
 protected:
+    // Nodes with at least this many children to update have them formatted on the thread pool in fixed size chunks.
+    static constexpr size_t parallel_update_threshold = 1024;
+    static constexpr size_t parallel_update_chunk_size = 256;
+
     static int indentation_level;
     Config& m_cfg;
     Process& m_process;
@@ -27,8 +66,26 @@ protected:
     std::string m_preamble_str{};
     std::string m_bytes_str{};
     std::string m_print_str{};
+    // False when the node's memory couldn't be read (its bytes are shown as ??), set by fetch.
+    bool m_readable{true};
+
+    // For memory that couldn't be read at all.
+    static const Process::PageMask unreadable;
 
     void display_address_offset(uintptr_t address, uintptr_t offset);
+
+    static bool is_shown(const Base* node) {
+        return filter == nullptr || !filter->only_matches || filter->matches.contains(node) ||
+               filter->ancestors.contains(node);
+    }
+    bool is_forced_open() const {
+        return filter != nullptr && filter->only_matches && filter->ancestors.contains(this);
+    }
+
+    // Calls update_child for every index in [0, count). Small counts are updated serially on the calling thread, large
+    // counts are split into chunks that get updated in parallel. The children have already been fetched so the pool
+    // only formats, and each child only writes to its own strings so the result is the same as updating serially.
+    static void update_children(size_t count, const std::function<void(size_t)>& update_child);
 };
 
 } // namespace node
@@ -90,6 +90,12 @@ void Bitfield::display(uintptr_t address, uintptr_t offset, std::byte* mem) {
     }
 }
 
+void Bitfield::filter_text(std::vector<std::string_view>& out) {
+    out.emplace_back(m_var->name());
+    out.emplace_back(m_var->type()->name());
+    out.emplace_back(m_display_str);
+}
+
 void Bitfield::update(uintptr_t address, uintptr_t offset, std::byte* mem) {
     Base::update(address, offset, mem);
     m_display_str.clear();
@@ -11,6 +11,7 @@ public:
 
     void display(uintptr_t address, uintptr_t offset, std::byte* mem) override;
     void update(uintptr_t address, uintptr_t offset, std::byte* mem) override;
+    void filter_text(std::vector<std::string_view>& out) override;
 
 private:
     std::string m_display_str{};
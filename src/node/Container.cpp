@@ -0,0 +1,380 @@
+#include <fmt/format.h>
+#include <utf8.h>
+
+#include "../Utility.hpp"
+
+#include "Container.hpp"
+
+namespace node {
+namespace {
+// Never read more than this many characters of a string.
+constexpr size_t max_string_length = 1024;
+} // namespace
+
+Container::Container(Config& cfg, Process& process, sdkgenny::Variable* var, Property& props)
+    : Elements{cfg, process, var, props, 1000} {
+    auto kind = container_kind(var);
+    assert(kind);
+
+    std::tie(m_kind, m_abi) = *kind;
+    m_fits = var->size() >= container_size(m_kind, m_abi, process.pointer_size());
+
+    if (m_kind != Kind::String && m_kind != Kind::WString) {
+        m_element_type = element_type(var);
+        assert(m_element_type != nullptr);
+        m_element_size = std::max<size_t>(m_element_type->size(), 1);
+    }
+}
+
+bool Container::is_container(sdkgenny::Variable* var) {
+    auto kind = container_kind(var);
+
+    // The target's pointer size isn't known here so this only rules out what's too small for any target (see m_fits).
+    if (!kind || var->size() < container_size(kind->first, kind->second, sizeof(uint32_t))) {
+        return false;
+    }
+
+    if (kind->first == Kind::String || kind->first == Kind::WString) {
+        return true;
+    }
+
+    return element_type(var) != nullptr;
+}
+
+std::optional<std::pair<Container::Kind, Container::Abi>> Container::container_kind(sdkgenny::Variable* var) {
+    std::optional<Kind> kind{};
+    auto abi = Abi::Msvc;
+    std::array<std::vector<std::string>*, 2> metadatas{&var->metadata(), &var->type()->metadata()};
+
+    for (auto&& metadata : metadatas) {
+        for (auto&& md : *metadata) {
+            if (md == "vector") {
+                kind = Kind::Vector;
+            } else if (md == "string") {
+                kind = Kind::String;
+            } else if (md == "wstring") {
+                kind = Kind::WString;
+            } else if (md == "list") {
+                kind = Kind::List;
+            } else if (md == "map" || md == "set") {
+                kind = Kind::Tree;
+            } else if (md == "unordered_map" || md == "unordered_set") {
+                kind = Kind::Hash;
+            } else if (md == "gnu") {
+                abi = Abi::Gnu;
+            }
+        }
+    }
+
+    if (!kind) {
+        return std::nullopt;
+    }
+
+    return std::make_pair(*kind, abi);
+}
+
+size_t Container::container_size(Kind kind, Abi abi, size_t ptr_size) {
+    switch (kind) {
+    case Kind::Vector:
+        return 3 * ptr_size;
+    case Kind::String:
+    case Kind::WString:
+        return 0x10 + 2 * ptr_size;
+    case Kind::List:
+        return abi == Abi::Msvc ? 2 * ptr_size : 3 * ptr_size;
+    case Kind::Tree:
+        return abi == Abi::Msvc ? 2 * ptr_size : 6 * ptr_size;
+    case Kind::Hash:
+        return abi == Abi::Msvc ? 8 * ptr_size : 7 * ptr_size;
+    default:
+        return 0;
+    }
+}
+
+uintptr_t Container::word(std::byte* mem, size_t index) const {
+    return m_process.load_pointer(mem + index * m_process.pointer_size());
+}
+
+sdkgenny::Type* Container::element_type(sdkgenny::Variable* var) {
+    auto struct_ = dynamic_cast<sdkgenny::Struct*>(var->type());
+
+    if (struct_ == nullptr) {
+        return nullptr;
+    }
+
+    std::vector<std::pair<uintptr_t, sdkgenny::Variable*>> variables{};
+    collect_variables(struct_, 0, variables);
+    std::sort(variables.begin(), variables.end(), [](auto&& a, auto&& b) { return a.first < b.first; });
+
+    for (auto&& [offset, member] : variables) {
+        if (auto ptr = dynamic_cast<sdkgenny::Pointer*>(member->type())) {
+            return ptr->to();
+        }
+    }
+
+    return nullptr;
+}
+
+void Container::fetch(uintptr_t address, std::byte* mem, const Process::PageMask* mask) {
+    Base::fetch(address, mem, mask);
+
+    if (!m_fits) {
+        return;
+    }
+
+    if (m_kind == Kind::String || m_kind == Kind::WString) {
+        read_string(address, mem);
+        return;
+    }
+
+    read_count(mem);
+
+    if (is_collapsed()) {
+        return;
+    }
+
+    find_elements(address, mem);
+    fetch_elements();
+}
+
+std::vector<uintptr_t> Container::find_all_elements(uintptr_t address, std::byte* mem) {
+    if (!m_fits) {
+        return {};
+    }
+
+    if (m_kind == Kind::String || m_kind == Kind::WString) {
+        read_string(address, mem);
+        return {};
+    }
+
+    read_count(mem);
+
+    // The whole container is one page starting at the first element.
+    auto start = start_element();
+    auto count = num_elements_displayed();
+
+    start_element() = 0;
+    num_elements_displayed() = max_elements();
+    find_elements(address, mem);
+    start_element() = start;
+    num_elements_displayed() = count;
+
+    return m_element_addresses;
+}
+
+void Container::update(uintptr_t address, uintptr_t offset, std::byte* mem) {
+    Base::update(address, offset, mem);
+    m_value_str.clear();
+
+    if (!m_fits) {
+        m_value_str = "(too small for the target's pointer size) ";
+        return;
+    }
+
+    if (m_kind == Kind::String || m_kind == Kind::WString) {
+        format_string();
+        return;
+    }
+
+    fmt::format_to(std::back_inserter(m_value_str), "size={} ", m_count);
+
+    if (is_collapsed()) {
+        return;
+    }
+
+    if (m_truncated) {
+        m_value_str += "(truncated) ";
+    }
+
+    update_elements();
+}
+
+void Container::read_count(std::byte* mem) {
+    switch (m_kind) {
+    case Kind::Vector: {
+        auto first = word(mem, 0);
+        auto last = word(mem, 1);
+        m_count = last > first ? (last - first) / m_element_size : 0;
+    } break;
+
+    case Kind::List:
+        m_count = word(mem, m_abi == Abi::Msvc ? 1 : 2);
+        break;
+
+    case Kind::Tree:
+        m_count = word(mem, m_abi == Abi::Msvc ? 1 : 5);
+        break;
+
+    case Kind::Hash:
+        m_count = word(mem, m_abi == Abi::Msvc ? 2 : 3);
+        break;
+
+    default:
+        m_count = 0;
+        break;
+    }
+}
+
+void Container::read_string(uintptr_t address, std::byte* mem) {
+    auto char_size = m_kind == Kind::WString ? sizeof(char16_t) : sizeof(char);
+    uintptr_t data{};
+    size_t size{};
+
+    if (m_abi == Abi::Msvc) {
+        // Small strings live in the 16 byte buffer at the start of the string itself.
+        size = m_process.load_pointer(mem + 0x10);
+        auto capacity = m_process.load_pointer(mem + 0x10 + m_process.pointer_size());
+        data = capacity < 16 / char_size ? address : word(mem, 0);
+    } else {
+        data = word(mem, 0);
+        size = word(mem, 1);
+    }
+
+    auto length = std::min(size, max_string_length);
+
+    m_string_size = size;
+
+    if (m_kind == Kind::WString) {
+        m_utf16.resize(length);
+        m_string_readable = length == 0 || m_process.read(data, m_utf16.data(), length * char_size);
+    } else {
+        m_utf8.resize(length);
+        m_string_readable = length == 0 || m_process.read(data, m_utf8.data(), length);
+    }
+}
+
+void Container::format_string() {
+    if (!m_string_readable) {
+        m_value_str = "?? ";
+        return;
+    }
+
+    size_t length{};
+
+    if (m_kind == Kind::WString) {
+        length = m_utf16.size();
+
+        std::string utf8conv{};
+
+        try {
+            utf8conv = utf8::utf16to8(m_utf16);
+        } catch (utf8::invalid_utf16& e) {
+            utf8conv = e.what();
+        }
+
+        m_value_str = fmt::format("\"{}\" ", utf8conv);
+    } else {
+        length = m_utf8.size();
+        m_value_str = fmt::format("\"{}\" ", m_utf8);
+    }
+
+    if (m_string_size > length) {
+        fmt::format_to(std::back_inserter(m_value_str), "(size={}) ", m_string_size);
+    }
+}
+
+void Container::find_elements(uintptr_t address, std::byte* mem) {
+    auto ptr_size = m_process.pointer_size();
+
+    m_element_addresses.clear();
+    m_truncated = false;
+
+    switch (m_kind) {
+    case Kind::Vector: {
+        auto first = word(mem, 0);
+        auto start = (size_t)start_element();
+        auto end = std::min(start + num_elements_displayed(), m_count);
+
+        for (auto i = start; i < end; ++i) {
+            m_element_addresses.emplace_back(first + i * m_element_size);
+        }
+    } break;
+
+    case Kind::List:
+        if (m_abi == Abi::Msvc) {
+            // The head is a sentinel node allocated separately from the list.
+            auto head = word(mem, 0);
+
+            if (auto first = m_process.read_pointer(head)) {
+                walk_list(*first, head, 2 * ptr_size);
+            }
+        } else {
+            // The sentinel is embedded in the list itself.
+            walk_list(word(mem, 0), address, 2 * ptr_size);
+        }
+        break;
+
+    case Kind::Tree:
+        if (m_abi == Abi::Msvc) {
+            // The head is a sentinel whose parent is the root; every leaf points back at the head.
+            auto head = word(mem, 0);
+
+            if (auto root = m_process.read_pointer(head + ptr_size)) {
+                walk_tree(*root, head);
+            }
+        } else {
+            walk_tree(word(mem, 2), 0);
+        }
+        break;
+
+    case Kind::Hash:
+        if (m_abi == Abi::Msvc) {
+            // Every element is kept in a std::list that the buckets index into.
+            auto head = word(mem, 1);
+
+            if (auto first = m_process.read_pointer(head)) {
+                walk_list(*first, head, 2 * ptr_size);
+            }
+        } else {
+            // A singly linked list hanging off _M_before_begin.
+            walk_list(word(mem, 2), 0, ptr_size);
+        }
+        break;
+
+    default:
+        break;
+    }
+}
+
+void Container::walk_list(uintptr_t first, uintptr_t end, size_t value_offset) {
+    auto start = (size_t)start_element();
+    auto page_size = (size_t)num_elements_displayed();
+
+    // Getting to the page is one read per element before it. While the list starts at the same node and has the same
+    // size the page is assumed to start where it did last refresh, so only the page itself is walked.
+    if (m_page_start && m_page_start->first == first && m_page_start->count == m_count &&
+        m_page_start->start == start && start + page_size <= (size_t)max_elements()) {
+        for (auto node : walk_lists({m_page_start->node}, 0, end, page_size)) {
+            m_element_addresses.emplace_back(node + value_offset);
+        }
+
+        return;
+    }
+
+    auto nodes = walk_lists({first}, 0, end, start + page_size);
+
+    m_page_start.reset();
+
+    if (start < nodes.size()) {
+        m_page_start = PageStart{first, m_count, start, nodes[start]};
+    }
+
+    for (auto i = start; i < nodes.size(); ++i) {
+        m_element_addresses.emplace_back(nodes[i] + value_offset);
+    }
+}
+
+void Container::walk_tree(uintptr_t root, uintptr_t nil) {
+    auto start = (size_t)start_element();
+    auto limit = start + num_elements_displayed();
+    auto ptr_size = m_process.pointer_size();
+    // MSVC nodes start with left, parent, right. libstdc++ nodes start with the color then parent, left, right. Either
+    // way the value follows 4 pointers in.
+    auto nodes = m_abi == Abi::Msvc ? walk_trees({root}, 0, 2 * ptr_size, nil, limit)
+                                    : walk_trees({root}, 2 * ptr_size, 3 * ptr_size, nil, limit);
+
+    for (auto i = start; i < nodes.size(); ++i) {
+        m_element_addresses.emplace_back(nodes[i] + 4 * ptr_size);
+    }
+}
+} // namespace node
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <optional>
+
+#include "Elements.hpp"
+
+namespace node {
+// Displays the elements of MSVC STL and libstdc++ containers. The container is picked with metadata on the variable or
+// its type: vector, string, wstring, list, map, set, unordered_map or unordered_set, plus gnu for the libstdc++ layouts
+// (MSVC is the default). Except for strings, the element type is taken from the first pointer member of the type, eg.
+//
+//     struct ItemVector 0x18 [[vector]] { Item* first @ 0 }
+//
+// For node based containers that's the type of the value stored in each node (the pair for maps). The layouts follow
+// the target's pointer size, so the same vector in a 32-bit process is
+//
+//     struct ItemVector 0xC [[vector]] { Item* first @ 0 }
+class Container : public Elements {
+public:
+    enum class Kind {
+        Vector,
+        String,
+        WString,
+        List,
+        Tree,
+        Hash
+    };
+
+    enum class Abi {
+        Msvc,
+        Gnu
+    };
+
+    Container(Config& cfg, Process& process, sdkgenny::Variable* var, Property& props);
+
+    static bool is_container(sdkgenny::Variable* var);
+
+    void update(uintptr_t address, uintptr_t offset, std::byte* mem) override;
+    void fetch(uintptr_t address, std::byte* mem, const Process::PageMask* mask) override;
+    std::vector<uintptr_t> find_all_elements(uintptr_t address, std::byte* mem) override;
+
+protected:
+    Kind m_kind{};
+    Abi m_abi{};
+    // Whether the variable is big enough for the container's layout in the target.
+    bool m_fits{};
+
+    // Number of elements according to the container.
+    size_t m_count{};
+    // Size of a string according to the string (only up to max_string_length of it is read) and whether reading it
+    // worked.
+    size_t m_string_size{};
+    bool m_string_readable{};
+
+    // The node the displayed page of a list started at, and what the list looked like then (see walk_list).
+    struct PageStart {
+        uintptr_t first{};
+        size_t count{};
+        size_t start{};
+        uintptr_t node{};
+    };
+
+    std::optional<PageStart> m_page_start{};
+
+    static std::optional<std::pair<Kind, Abi>> container_kind(sdkgenny::Variable* var);
+    static size_t container_size(Kind kind, Abi abi, size_t ptr_size);
+    static sdkgenny::Type* element_type(sdkgenny::Variable* var);
+
+    // Containers are nothing but pointers and sizes, both of which are the target's pointer size. Loads the index'th of
+    // them.
+    uintptr_t word(std::byte* mem, size_t index) const;
+    void read_count(std::byte* mem);
+    void read_string(uintptr_t address, std::byte* mem);
+    void format_string();
+    void find_elements(uintptr_t address, std::byte* mem);
+    void walk_list(uintptr_t first, uintptr_t end, size_t value_offset);
+    void walk_tree(uintptr_t root, uintptr_t nil);
+
+    bool has_elements() const override { return m_kind != Kind::String && m_kind != Kind::WString; }
+};
+} // namespace node
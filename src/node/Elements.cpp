@@ -0,0 +1,318 @@
+#include <unordered_map>
+#include <unordered_set>
+
+#include <fmt/format.h>
+#include <imgui.h>
+
+#include "Factory.hpp"
+#include "Struct.hpp"
+
+#include "Elements.hpp"
+
+namespace node {
+Elements::Elements(Config& cfg, Process& process, sdkgenny::Variable* var, Property& props, int default_max_elements)
+    : Variable{cfg, process, var, props} {
+    m_props["__collapsed"].set_default(true);
+    m_props["__start"].set_default(0);
+    m_props["__count"].set_default(10);
+    m_props["__max"].set_default(default_max_elements);
+
+    // Make sure inherited props are within acceptable ranges.
+    max_elements() = std::max(max_elements(), 1);
+    start_element() = std::max(start_element(), 0);
+    num_elements_displayed() = std::clamp(num_elements_displayed(), 0, max_elements());
+}
+
+void Elements::display(uintptr_t address, uintptr_t offset, std::byte* mem) {
+    display_address_offset(address, offset);
+    ImGui::SameLine();
+    ImGui::BeginGroup();
+    display_type();
+    ImGui::SameLine();
+    display_name();
+
+    if (!m_value_str.empty()) {
+        ImGui::SameLine();
+        ImGui::PushStyleColor(ImGuiCol_Text, {181.0f / 255.0f, 206.0f / 255.0f, 168.0f / 255.0f, 1.0f});
+        ImGui::TextUnformatted(m_value_str.c_str());
+        ImGui::PopStyleColor();
+    }
+
+    ImGui::EndGroup();
+
+    if (!has_elements()) {
+        return;
+    }
+
+    if (ImGui::IsItemClicked()) {
+        is_collapsed() = !is_collapsed();
+    }
+
+    if (ImGui::BeginPopupContextItem("ElementsNode")) {
+        if (ImGui::InputInt("Start element", &start_element())) {
+            start_element() = std::max(start_element(), 0);
+        }
+
+        if (ImGui::InputInt("# Elements displayed", &num_elements_displayed())) {
+            num_elements_displayed() = std::clamp(num_elements_displayed(), 0, max_elements());
+        }
+
+        if (ImGui::InputInt("Max elements walked", &max_elements())) {
+            max_elements() = std::max(max_elements(), 1);
+            num_elements_displayed() = std::min(num_elements_displayed(), max_elements());
+        }
+
+        ImGui::EndPopup();
+    }
+
+    // The element nodes are only (re)created by fetch so they can lag a refresh behind the props.
+    if ((is_collapsed() && !is_forced_open()) || m_elements.size() != m_element_addresses.size()) {
+        return;
+    }
+
+    for (size_t i = 0; i < m_elements.size(); ++i) {
+        auto& cur_node = m_elements[i];
+
+        if (!is_shown(cur_node.get())) {
+            continue;
+        }
+
+        ++indentation_level;
+        ImGui::PushID(cur_node.get());
+        cur_node->display(m_element_addresses[i], 0, &m_mem[i * m_element_size]);
+        ImGui::PopID();
+        --indentation_level;
+    }
+}
+
+void Elements::for_each_child(const std::function<void(Base&)>& fn) {
+    for (auto&& element : m_elements) {
+        fn(*element);
+    }
+}
+
+std::vector<uintptr_t> Elements::walk_lists(
+    const std::vector<uintptr_t>& heads, uintptr_t next_offset, uintptr_t end, size_t limit) {
+    struct Chain {
+        uintptr_t node{};
+        uintptr_t next{};
+        std::vector<uintptr_t> found{};
+    };
+
+    auto max = (size_t)max_elements();
+    std::vector<Chain> chains(heads.size());
+    std::vector<Chain*> live{};
+    std::vector<Process::ReadRequest> requests{};
+    std::unordered_set<uintptr_t> visited{};
+
+    for (size_t i = 0; i < heads.size(); ++i) {
+        chains[i].node = heads[i];
+
+        if (heads[i] != 0 && heads[i] != end) {
+            live.emplace_back(&chains[i]);
+        }
+    }
+
+    // One hop of every live list per batch.
+    while (!live.empty()) {
+        requests.clear();
+
+        for (auto it = live.begin(); it != live.end();) {
+            auto chain = *it;
+
+            if (visited.size() >= std::min(limit, max)) {
+                // Stopping for the limit is just the end of what was asked for.
+                m_truncated |= visited.size() >= max;
+                live.erase(it, live.end());
+                break;
+            }
+
+            if (!visited.emplace(chain->node).second) {
+                m_truncated = true;
+                it = live.erase(it);
+                continue;
+            }
+
+            chain->found.emplace_back(chain->node);
+            requests.emplace_back(
+                Process::ReadRequest{chain->node + next_offset, &chain->next, m_process.pointer_size()});
+            ++it;
+        }
+
+        m_process.read_batch(requests);
+
+        for (size_t i = 0; i < requests.size(); ++i) {
+            live[i]->node = requests[i].ok ? m_process.load_pointer(&live[i]->next) : 0;
+        }
+
+        std::erase_if(live, [end](auto chain) { return chain->node == 0 || chain->node == end; });
+    }
+
+    std::vector<uintptr_t> out{};
+
+    for (auto&& chain : chains) {
+        out.insert(out.end(), chain.found.begin(), chain.found.end());
+    }
+
+    return out;
+}
+
+std::vector<uintptr_t> Elements::walk_trees(const std::vector<uintptr_t>& roots, uintptr_t left_offset,
+    uintptr_t right_offset, uintptr_t nil, size_t limit) {
+    struct Children {
+        uintptr_t left{};
+        uintptr_t right{};
+    };
+
+    auto max = (size_t)max_elements();
+    auto lo = std::min(left_offset, right_offset);
+    auto span = std::max(left_offset, right_offset) + m_process.pointer_size() - lo;
+    std::unordered_map<uintptr_t, Children> nodes{};
+    std::vector<uintptr_t> level{};
+    std::vector<std::byte> scratch{};
+    std::vector<Process::ReadRequest> requests{};
+
+    auto is_link = [nil](uintptr_t n) { return n != 0 && n != nil; };
+
+    for (auto root : roots) {
+        if (is_link(root)) {
+            level.emplace_back(root);
+        }
+    }
+
+    // Both links of every node on a level (across all the trees) are fetched in one batch so the number of round trips
+    // is the height of the tallest tree rather than the number of nodes.
+    while (!level.empty()) {
+        scratch.assign(level.size() * span, {});
+        requests.clear();
+
+        for (size_t i = 0; i < level.size(); ++i) {
+            requests.emplace_back(Process::ReadRequest{level[i] + lo, &scratch[i * span], span});
+        }
+
+        m_process.read_batch(requests);
+
+        std::vector<uintptr_t> next_level{};
+
+        for (size_t i = 0; i < level.size(); ++i) {
+            if (!requests[i].ok) {
+                continue;
+            }
+
+            if (nodes.size() >= max) {
+                m_truncated = true;
+                break;
+            }
+
+            Children children{};
+            children.left = m_process.load_pointer(&scratch[i * span + left_offset - lo]);
+            children.right = m_process.load_pointer(&scratch[i * span + right_offset - lo]);
+
+            if (!nodes.emplace(level[i], children).second) {
+                m_truncated = true;
+                continue;
+            }
+
+            for (auto child : {children.left, children.right}) {
+                if (is_link(child) && !nodes.contains(child)) {
+                    next_level.emplace_back(child);
+                }
+            }
+        }
+
+        level = std::move(next_level);
+    }
+
+    // In-order walk of each tree over what was fetched.
+    std::vector<uintptr_t> out{};
+    std::unordered_set<uintptr_t> visited{};
+    std::vector<uintptr_t> stack{};
+    auto is_valid = [&](uintptr_t n) { return is_link(n) && nodes.contains(n) && !visited.contains(n); };
+
+    for (auto root : roots) {
+        auto node = root;
+
+        while ((is_valid(node) || !stack.empty()) && out.size() < limit) {
+            while (is_valid(node)) {
+                stack.emplace_back(node);
+                visited.emplace(node);
+                node = nodes[node].left;
+            }
+
+            node = stack.back();
+            stack.pop_back();
+            out.emplace_back(node);
+            node = nodes[node].right;
+        }
+
+        stack.clear();
+    }
+
+    return out;
+}
+
+void Elements::fetch_elements() {
+    read_elements();
+    create_nodes();
+
+    for (size_t i = 0; i < m_elements.size(); ++i) {
+        auto mask = m_element_ok[i] ? nullptr : &unreadable;
+        m_elements[i]->fetch(m_element_addresses[i], &m_mem[i * m_element_size], mask);
+    }
+}
+
+void Elements::update_elements() {
+    update_children(m_elements.size(), [&](size_t i) {
+        m_elements[i]->update(m_element_addresses[i], 0, &m_mem[i * m_element_size]);
+    });
+}
+
+void Elements::read_elements() {
+    m_mem.assign(m_element_addresses.size() * m_element_size, {});
+
+    std::vector<Process::ReadRequest> requests{};
+    requests.reserve(m_element_addresses.size());
+
+    for (size_t i = 0; i < m_element_addresses.size(); ++i) {
+        requests.emplace_back(Process::ReadRequest{m_element_addresses[i], &m_mem[i * m_element_size], m_element_size});
+    }
+
+    m_process.read_batch(requests);
+    m_mem_usage.set(m_mem.capacity());
+
+    m_element_ok.resize(requests.size());
+
+    for (size_t i = 0; i < requests.size(); ++i) {
+        m_element_ok[i] = requests[i].ok;
+    }
+}
+
+void Elements::create_nodes() {
+    auto start = start_element();
+
+    if (start == m_nodes_start && m_elements.size() == m_element_addresses.size()) {
+        return;
+    }
+
+    m_proxy_variables.clear();
+    m_elements.clear();
+
+    for (size_t i = 0; i < m_element_addresses.size(); ++i) {
+        auto proxy_variable = std::make_unique<sdkgenny::Variable>(fmt::format("{}[{}]", m_var->name(), start + i));
+        auto&& proxy_props = m_props[proxy_variable->name()];
+
+        proxy_variable->type(m_element_type);
+
+        auto node = make_node(m_cfg, m_process, proxy_variable.get(), proxy_props);
+
+        if (auto struct_ = dynamic_cast<Struct*>(node.get())) {
+            struct_->is_collapsed(false);
+        }
+
+        m_proxy_variables.emplace_back(std::move(proxy_variable));
+        m_elements.emplace_back(std::move(node));
+    }
+
+    m_nodes_start = start;
+}
+} // namespace node
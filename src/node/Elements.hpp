@@ -0,0 +1,87 @@
+#pragma once
+
+#include "../MemoryAccountant.hpp"
+#include "Variable.hpp"
+
+namespace node {
+// Base of the nodes that display a page of elements found at runtime (Container and Walker). It owns the paging props,
+// the element nodes of the displayed page and their memory, and the batched list and tree walks that find elements.
+class Elements : public Variable {
+public:
+    Elements(Config& cfg, Process& process, sdkgenny::Variable* var, Property& props, int default_max_elements);
+
+    void display(uintptr_t address, uintptr_t offset, std::byte* mem) override;
+    void for_each_child(const std::function<void(Base&)>& fn) override;
+
+    auto is_collapsed(bool is_collapsed) {
+        m_props["__collapsed"].set(is_collapsed);
+        return this;
+    }
+    auto& is_collapsed() { return m_props["__collapsed"].as_bool(); }
+
+    void expand() override { is_collapsed() = false; }
+
+    auto start_element(int start_element) {
+        m_props["__start"].set(start_element);
+        return this;
+    }
+    auto& start_element() { return m_props["__start"].as_int(); }
+
+    auto num_elements_displayed(int num_elements) {
+        m_props["__count"].set(num_elements);
+        return this;
+    }
+    auto& num_elements_displayed() { return m_props["__count"].as_int(); }
+
+    // Walks never go past this many elements (which also stops us from walking corrupted or cyclic lists forever).
+    auto max_elements(int max_elements) {
+        m_props["__max"].set(max_elements);
+        return this;
+    }
+    auto& max_elements() { return m_props["__max"].as_int(); }
+
+    // Finds every element (up to max_elements()) from the node's own memory without reading them or making nodes for
+    // them, eg. to capture them in a snapshot.
+    virtual std::vector<uintptr_t> find_all_elements(uintptr_t address, std::byte* mem) = 0;
+    auto type_of_elements() const { return m_element_type; }
+
+protected:
+    sdkgenny::Type* m_element_type{};
+    size_t m_element_size{};
+
+    // Set when a walk stopped early because of max_elements() or a cycle.
+    bool m_truncated{};
+
+    // Addresses and values of the displayed elements.
+    std::vector<uintptr_t> m_element_addresses{};
+    std::vector<std::byte> m_mem{};
+    // Whether each element could be read.
+    std::vector<bool> m_element_ok{};
+    MemoryAccountant::Usage m_mem_usage{MemoryAccountant::Category::PointerBuffers};
+
+    std::vector<std::unique_ptr<Variable>> m_elements{};
+    std::vector<std::unique_ptr<sdkgenny::Variable>> m_proxy_variables{};
+    int m_nodes_start{-1};
+
+    // False for nodes that are just a value (eg. a Container that's a string).
+    virtual bool has_elements() const { return true; }
+
+    // Follows every list from its head, one hop of every list per read_batch, until it ends (at 0 or end), loops or
+    // limit nodes have been found in total. The next pointer is at next_offset in each node. Returns the nodes list
+    // after list.
+    std::vector<uintptr_t> walk_lists(
+        const std::vector<uintptr_t>& heads, uintptr_t next_offset, uintptr_t end, size_t limit);
+    // Fetches the links of every tree a whole level (of all of them) per read_batch, then returns up to limit of their
+    // nodes in order, tree after tree. Links equal to 0 or nil are leaves.
+    std::vector<uintptr_t> walk_trees(const std::vector<uintptr_t>& roots, uintptr_t left_offset,
+        uintptr_t right_offset, uintptr_t nil, size_t limit);
+
+    // Reads the elements at m_element_addresses in one batch, (re)creates their nodes and fetches them.
+    void fetch_elements();
+    void update_elements();
+
+private:
+    void read_elements();
+    void create_nodes();
+};
+} // namespace node
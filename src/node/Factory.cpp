@@ -0,0 +1,34 @@
+#include "Array.hpp"
+#include "Bitfield.hpp"
+#include "Container.hpp"
+#include "Pointer.hpp"
+#include "Struct.hpp"
+#include "Walker.hpp"
+
+#include "Factory.hpp"
+
+namespace node {
+std::unique_ptr<Variable> make_node(Config& cfg, Process& process, sdkgenny::Variable* var, Property& props) {
+    return make_node(cfg, process, var, props, LayoutCache::classify(var));
+}
+
+std::unique_ptr<Variable> make_node(
+    Config& cfg, Process& process, sdkgenny::Variable* var, Property& props, NodeKind kind) {
+    switch (kind) {
+    case NodeKind::Container:
+        return std::make_unique<Container>(cfg, process, var, props);
+    case NodeKind::Walker:
+        return std::make_unique<Walker>(cfg, process, var, props);
+    case NodeKind::Array:
+        return std::make_unique<Array>(cfg, process, var, props);
+    case NodeKind::Struct:
+        return std::make_unique<Struct>(cfg, process, var, props);
+    case NodeKind::Pointer:
+        return std::make_unique<Pointer>(cfg, process, var, props);
+    case NodeKind::Bitfield:
+        return std::make_unique<Bitfield>(cfg, process, var, props);
+    default:
+        return std::make_unique<Variable>(cfg, process, var, props);
+    }
+}
+} // namespace node
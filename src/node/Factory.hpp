@@ -0,0 +1,15 @@
+#pragma once
+
+#include <memory>
+
+#include "LayoutCache.hpp"
+#include "Variable.hpp"
+
+namespace node {
+// Creates the node used to display var. Specialized nodes are picked from the variable's type and metadata (see
+// Container and Walker for the metadata they use).
+std::unique_ptr<Variable> make_node(Config& cfg, Process& process, sdkgenny::Variable* var, Property& props);
+// Same as above when the kind is already known (eg. from LayoutCache).
+std::unique_ptr<Variable> make_node(
+    Config& cfg, Process& process, sdkgenny::Variable* var, Property& props, NodeKind kind);
+} // namespace node
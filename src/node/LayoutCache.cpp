@@ -0,0 +1,115 @@
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <shared_mutex>
+#include <unordered_map>
+
+#include "Container.hpp"
+#include "Walker.hpp"
+
+#include "LayoutCache.hpp"
+
+namespace node {
+namespace {
+std::shared_mutex g_lock{};
+std::unordered_map<sdkgenny::Struct*, std::unique_ptr<LayoutCache::Layout>> g_layouts{};
+std::unordered_map<sdkgenny::Type*, size_t> g_sizes{};
+
+std::unique_ptr<LayoutCache::Layout> build_layout(sdkgenny::Struct* struct_) {
+    auto layout = std::make_unique<LayoutCache::Layout>();
+    std::set<uintptr_t> bitfield_offsets{};
+
+    std::function<void(uintptr_t, sdkgenny::Struct*)> add_vars = [&](uintptr_t offset, sdkgenny::Struct* s) {
+        auto parent_offset = offset;
+
+        for (auto&& parent : s->parents()) {
+            add_vars(parent_offset, parent);
+            parent_offset += parent->size();
+        }
+
+        for (auto&& var : s->get_all<sdkgenny::Variable>()) {
+            if (var->is_bitfield()) {
+                bitfield_offsets.emplace(offset + var->offset());
+            } else {
+                layout->members.emplace_back(offset + var->offset(), var, LayoutCache::classify(var));
+            }
+        }
+    };
+
+    add_vars(0, struct_);
+
+    for (auto offset : bitfield_offsets) {
+        LayoutCache::BitfieldGroup group{.offset = offset};
+
+        for (auto&& [bit_offset, var] : struct_->bitfield(offset)) {
+            group.fields.emplace_back(bit_offset, var->bit_size(), var->size(), var, LayoutCache::classify(var));
+            group.storage_size = var->type()->size();
+        }
+
+        if (!group.fields.empty()) {
+            layout->bitfields.emplace_back(std::move(group));
+        }
+    }
+
+    return layout;
+}
+} // namespace
+
+const LayoutCache::Layout& LayoutCache::layout(sdkgenny::Struct* struct_) {
+    {
+        std::shared_lock _{g_lock};
+
+        if (auto it = g_layouts.find(struct_); it != g_layouts.end()) {
+            return *it->second;
+        }
+    }
+
+    // Built outside the lock, if another thread beat us to it theirs is kept.
+    auto layout = build_layout(struct_);
+
+    std::unique_lock _{g_lock};
+    return *g_layouts.try_emplace(struct_, std::move(layout)).first->second;
+}
+
+size_t LayoutCache::size(sdkgenny::Type* type) {
+    {
+        std::shared_lock _{g_lock};
+
+        if (auto it = g_sizes.find(type); it != g_sizes.end()) {
+            return it->second;
+        }
+    }
+
+    auto size = type->size();
+
+    std::unique_lock _{g_lock};
+    g_sizes.emplace(type, size);
+
+    return size;
+}
+
+void LayoutCache::clear() {
+    std::unique_lock _{g_lock};
+    g_layouts.clear();
+    g_sizes.clear();
+}
+
+NodeKind LayoutCache::classify(sdkgenny::Variable* var) {
+    if (Container::is_container(var)) {
+        return NodeKind::Container;
+    } else if (Walker::is_walker(var)) {
+        return NodeKind::Walker;
+    } else if (var->type()->is_a<sdkgenny::Array>()) {
+        return NodeKind::Array;
+    } else if (var->type()->is_a<sdkgenny::Struct>()) {
+        return NodeKind::Struct;
+    } else if (var->type()->is_a<sdkgenny::Pointer>()) {
+        return NodeKind::Pointer;
+    } else if (var->is_bitfield()) {
+        return NodeKind::Bitfield;
+    } else {
+        return NodeKind::Variable;
+    }
+}
+} // namespace node
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <sdkgenny.hpp>
+
+namespace node {
+// Which node make_node creates for a variable.
+enum class NodeKind {
+    Container,
+    Walker,
+    Array,
+    Struct,
+    Pointer,
+    Bitfield,
+    Variable,
+};
+
+// What the node tree needs to know about the sdk's types, worked out once per type instead of walking the type graph
+// (parents, bitfields, sizes, metadata) every time a node is built or refreshed. Everything is keyed by the sdk's own
+// pointers so it must be cleared whenever the sdk is replaced.
+class LayoutCache {
+public:
+    struct Member {
+        // From the start of the struct, with the members of parents flattened in.
+        uintptr_t offset{};
+        sdkgenny::Variable* var{};
+        NodeKind kind{};
+    };
+
+    struct BitfieldField {
+        uintptr_t bit_offset{};
+        size_t bit_size{};
+        // Of the field's type.
+        size_t size{};
+        sdkgenny::Variable* var{};
+        NodeKind kind{};
+    };
+
+    // Bitfields sharing the same storage.
+    struct BitfieldGroup {
+        uintptr_t offset{};
+        size_t storage_size{};
+        std::vector<BitfieldField> fields{};
+    };
+
+    struct Layout {
+        std::vector<Member> members{};
+        std::vector<BitfieldGroup> bitfields{};
+    };
+
+    // Safe to call from the update threads. References stay valid until clear.
+    static const Layout& layout(sdkgenny::Struct* struct_);
+    static size_t size(sdkgenny::Type* type);
+    static void clear();
+
+    // Not cached, variables made up by nodes (array elements, pointees) come and go.
+    static NodeKind classify(sdkgenny::Variable* var);
+};
+} // namespace node
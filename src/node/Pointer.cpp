@@ -1,8 +1,14 @@
+#include <bit>
+#include <unordered_set>
+
 #include <fmt/format.h>
 #include <imgui.h>
+#include <spdlog/spdlog.h>
 #include <utf8.h>
 
+#include "../Utility.hpp"
 #include "Array.hpp"
+#include "LayoutCache.hpp"
 #include "Struct.hpp"
 
 #include "Pointer.hpp"
@@ -10,6 +16,23 @@
 using namespace std::literals;
 
 namespace node {
+std::shared_mutex Pointer::s_rtti_lock{};
+std::unordered_map<uintptr_t, Pointer::RttiType> Pointer::s_rtti_types{};
+
+bool Pointer::derives_from(sdkgenny::Struct* struct_, sdkgenny::Struct* base) {
+    if (struct_ == base) {
+        return true;
+    }
+
+    for (auto&& parent : struct_->parents()) {
+        if (derives_from(parent, base)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
 void Pointer::display_str(std::string& s, const std::string& str) {
     s += "\"";
 
@@ -38,6 +61,22 @@ Pointer::Pointer(Config& cfg, Process& process, sdkgenny::Variable* var, Propert
     if (array_count() < 1) {
         array_count() = 1;
     }
+
+    m_props["__max"].set_default(default_max_count);
+    max_count() = std::max(max_count(), 1);
+
+    for (auto&& md : m_var->metadata()) {
+        if (md.starts_with("count:")) {
+            m_count_path = md.substr(6);
+            m_count_field = find_count_field(m_var, m_count_path);
+        }
+    }
+
+    MemoryAccountant::get().add_evictable(MemoryAccountant::Category::PointerBuffers, this);
+}
+
+Pointer::~Pointer() {
+    MemoryAccountant::get().remove_evictable(MemoryAccountant::Category::PointerBuffers, this);
 }
 
 void Pointer::display(uintptr_t address, uintptr_t offset, std::byte* mem) {
@@ -69,12 +108,24 @@ void Pointer::display(uintptr_t address, uintptr_t offset, std::byte* mem) {
 
         m_is_hovered = ImGui::IsItemHovered();
 
+        // Get the memory of visible collapsed pointers ready ahead of time so expanding or hovering them is instant.
+        if (is_collapsed() && !m_is_hovered && ImGui::IsItemVisible()) {
+            auto count = is_count_bound() ? m_count : array_count();
+            m_process.prefetch(m_process.load_pointer(mem), LayoutCache::size(pointee()) * count);
+        }
+
         if (ImGui::BeginPopupContextItem("PointerNode")) {
-            if (ImGui::Checkbox("Is Array", &is_array())) {
+            if (is_count_bound()) {
+                ImGui::Text("Count: %s", m_count_path.c_str());
+
+                if (ImGui::InputInt("Max Count", &max_count())) {
+                    max_count() = std::max(max_count(), 1);
+                }
+            } else if (ImGui::Checkbox("Is Array", &is_array())) {
                 m_ptr_node = nullptr;
             }
 
-            if (is_array()) {
+            if (is_array() && !is_count_bound()) {
                 if (ImGui::InputInt("Array Count", &array_count())) {
                     if (array_count() < 1) {
                         array_count() = 1;
@@ -87,32 +138,59 @@ void Pointer::display(uintptr_t address, uintptr_t offset, std::byte* mem) {
             ImGui::EndPopup();
         }
 
-        if (is_collapsed() && !m_is_hovered) {
+        if (is_collapsed() && !m_is_hovered && !is_forced_open()) {
             return;
         }
     }
 
-    auto pointed_to_address = *(uintptr_t*)mem;
+    auto pointed_to_address = m_process.load_pointer(mem);
 
     if (pointed_to_address != m_address) {
         m_address = pointed_to_address;
     }
 
+    if (is_count_bound()) {
+        if (m_count == 0) {
+            return;
+        }
+
+        // The array is made for a power of two capacity so a buffer that keeps growing doesn't need a new array type
+        // (and nodes) every refresh. Only the first m_count elements are shown.
+        auto capacity = std::min(std::bit_ceil(std::max<size_t>(m_count, 16)), (size_t)max_count());
+
+        if (m_ptr_node != nullptr && capacity != m_count_capacity) {
+            m_ptr_node = nullptr;
+            m_mem_refresh_time = {};
+        }
+
+        m_count_capacity = capacity;
+    }
+
+    // The object pointed to changed to (or from) a derived type.
+    if (m_ptr_node != nullptr && m_node_type != pointee()) {
+        m_ptr_node = nullptr;
+        m_mem_refresh_time = {};
+    }
+
     // We create the node here right before displaying it to avoid pointer loop crashes. Only nodes that are uncollapsed
     // get created.
     if (m_ptr_node == nullptr) {
         auto&& var_name = m_var->name();
         auto&& props = m_props[var_name];
 
-        if (is_array()) {
+        if (is_count_bound()) {
+            m_proxy_var = std::make_unique<sdkgenny::Variable>(var_name);
+            m_proxy_var->type(m_ptr->to()->array_(m_count_capacity));
+            m_ptr_node = std::make_unique<Array>(m_cfg, m_process, m_proxy_var.get(), props);
+        } else if (is_array()) {
             m_proxy_var = std::make_unique<sdkgenny::Variable>(var_name);
             m_proxy_var->type(m_ptr->to()->array_(array_count()));
             m_ptr_node = std::make_unique<Array>(m_cfg, m_process, m_proxy_var.get(), props);
         } else {
             m_proxy_var = std::make_unique<sdkgenny::Variable>(var_name);
-            m_proxy_var->type(m_ptr->to());
+            m_proxy_var->type(pointee());
 
-            if (m_ptr->to()->is_a<sdkgenny::Struct>()) {
+            if (pointee()->is_a<sdkgenny::Struct>()) {
                 auto struct_ = std::make_unique<Struct>(m_cfg, m_process, m_proxy_var.get(), props);
                 struct_->display_self(false)->is_collapsed(false);
                 m_ptr_node = std::move(struct_);
@@ -122,6 +200,13 @@ void Pointer::display(uintptr_t address, uintptr_t offset, std::byte* mem) {
                 m_ptr_node = std::make_unique<Variable>(m_cfg, m_process, m_proxy_var.get(), props);
             }
         }
+
+        m_node_type = pointee();
+        m_node_type_size = LayoutCache::size(m_node_type);
+    }
+
+    if (auto arr = dynamic_cast<Array*>(m_ptr_node.get()); arr != nullptr && is_count_bound()) {
+        arr->limit_elements(m_count);
     }
 
     refresh_memory();
@@ -132,7 +217,12 @@ void Pointer::display(uintptr_t address, uintptr_t offset, std::byte* mem) {
         return;
     }
 
-    auto show_tooltip = is_collapsed() && m_is_hovered;
+    auto show_tooltip = is_collapsed() && m_is_hovered && !is_forced_open();
+
+    if (!show_tooltip && !is_shown(m_ptr_node.get())) {
+        return;
+    }
+
     auto backup_indentation_level = indentation_level;
 
     if (show_tooltip) {
@@ -158,17 +248,24 @@ void Pointer::update(uintptr_t address, uintptr_t offset, std::byte* mem) {
     m_value_str.clear();
     m_address_str.clear();
 
+    if (!m_readable) {
+        m_address_str = "??";
+        // Otherwise the array keeps showing the count from before.
+        m_count = 0;
+        return;
+    }
+
+    if (m_count_field) {
+        auto count = m_count_field->load(mem);
+
+        m_count = (size_t)std::min<uint64_t>(count, max_count());
+        fmt::format_to(std::back_inserter(m_value_str), "[{}] ", count);
+    }
+
     for (auto&& md : m_var->metadata()) {
         if (md == "utf8*") {
-            m_utf8.resize(256);
-            m_process.read(*(uintptr_t*)mem, m_utf8.data(), 255 * sizeof(char));
             display_str(m_value_str, m_utf8);
         } else if (md == "utf16*") {
-            m_utf16.resize(256);
-            m_process.read(*(uintptr_t*)mem, m_utf16.data(), 255 * sizeof(char16_t));
-
-            m_utf16.back() = L'\0';
-
             // if we don't do this then utf16to8 will throw an exception.
             // todo: do for utf32?
             const auto real_len = wcslen((wchar_t*)m_utf16.data());
@@ -184,9 +281,6 @@ void Pointer::update(uintptr_t address, uintptr_t offset, std::byte* mem) {
 
             display_str(m_value_str, utf8conv);
         } else if (md == "utf32*") {
-            m_utf32.resize(256);
-            m_process.read(*(uintptr_t*)mem, m_utf32.data(), 255 * sizeof(char32_t));
-
             std::string utf32conv{};
 
             try {
@@ -199,11 +293,23 @@ void Pointer::update(uintptr_t address, uintptr_t offset, std::byte* mem) {
         }
     }
 
-    auto addr = *(uintptr_t*)mem;
+    auto addr = m_process.load_pointer(mem);
+
+    // Show what the object really is when it's something derived from the declared type. Walking the parents is only
+    // done when the type changes.
+    if (m_rtti.type != m_derives_checked) {
+        auto declared = dynamic_cast<sdkgenny::Struct*>(m_ptr->to());
+
+        m_derives_checked = m_rtti.type;
+        m_derives = declared != nullptr && m_rtti.type != nullptr && m_rtti.type != declared &&
+                    derives_from(m_rtti.type, declared);
+    }
+
+    m_downcast = m_derives && !is_array() && !is_count_bound() ? m_rtti.type : nullptr;
 
     // RTTI
-    if (auto tn = m_process.get_typename(addr); tn) {
-        fmt::format_to(std::back_inserter(m_address_str), "obj*:{:s} ", *tn);
+    if (m_rtti.name) {
+        fmt::format_to(std::back_inserter(m_address_str), "obj*:{:s} ", *m_rtti.name);
     }
 
     for (auto&& mod : m_process.modules()) {
@@ -223,18 +329,270 @@ void Pointer::update(uintptr_t address, uintptr_t offset, std::byte* mem) {
     }
 }
 
+void Pointer::fetch(uintptr_t address, std::byte* mem, const Process::PageMask* mask) {
+    Base::fetch(address, mem, mask);
+
+    if (!m_readable) {
+        m_rtti = {};
+        m_rtti_vtable = 0;
+        return;
+    }
+
+    auto addr = m_process.load_pointer(mem);
+
+    for (auto&& md : m_var->metadata()) {
+        if (md == "utf8*") {
+            m_utf8.resize(256);
+            m_process.read(addr, m_utf8.data(), 255 * sizeof(char));
+        } else if (md == "utf16*") {
+            m_utf16.resize(256);
+            m_process.read(addr, m_utf16.data(), 255 * sizeof(char16_t));
+            m_utf16.back() = L'\0';
+        } else if (md == "utf32*") {
+            m_utf32.resize(256);
+            m_process.read(addr, m_utf32.data(), 255 * sizeof(char32_t));
+        }
+    }
+
+    fetch_rtti(addr);
+}
+
+void Pointer::filter_text(std::vector<std::string_view>& out) {
+    Variable::filter_text(out);
+    out.emplace_back(m_address_str);
+    out.emplace_back(m_value_str);
+}
+
+void Pointer::for_each_child(const std::function<void(Base&)>& fn) {
+    if (m_ptr_node != nullptr) {
+        fn(*m_ptr_node);
+    }
+}
+
 void Pointer::refresh_memory() {
-    if ((is_collapsed() && !m_is_hovered) || m_ptr->to()->size() == 0) {
+    if ((is_collapsed() && !m_is_hovered && !is_forced_open()) || m_node_type_size == 0) {
         return;
     }
 
-    if (auto now = std::chrono::steady_clock::now(); now >= m_mem_refresh_time) {
+    auto now = std::chrono::steady_clock::now();
+
+    m_last_used = now;
+
+    if (now >= m_mem_refresh_time) {
         m_mem_refresh_time = now + std::chrono::milliseconds(m_cfg.refresh_rate);
 
         // Make sure our memory buffer is large enough (since the first refresh it wont be).
-        m_mem.resize(m_ptr->to()->size() * array_count());
-        m_process.read(m_address, m_mem.data(), m_mem.size());
+        m_mem.resize(m_node_type_size * (is_count_bound() ? m_count_capacity : array_count()));
+        m_mem_usage.set(m_mem.capacity());
+
+        if (auto arr = dynamic_cast<Array*>(m_ptr_node.get()); arr != nullptr && is_count_bound()) {
+            // Only the elements on screen get read, in one go. Count bound pointers are never downcast so the node type
+            // is the element type.
+            auto element_size = m_node_type_size;
+            auto first = (size_t)arr->start_element() * element_size;
+            auto size = arr->num_live_elements() * element_size;
+
+            m_mask = m_process.read_partial(m_address + first, m_mem.data() + first, size);
+        } else if (m_process.read_prefetched(
+                       m_address, m_mem.data(), m_mem.size(), std::chrono::milliseconds(m_cfg.refresh_rate))) {
+            // What was prefetched is used for as long as it's no older than a refresh would be.
+            m_mask.reset();
+        } else {
+            // Whatever isn't readable is zeroed and its nodes show ?? (see Base::fetch).
+            m_mask = m_process.read_partial(m_address, m_mem.data(), m_mem.size());
+        }
+
+        m_ptr_node->fetch(m_address, &m_mem[0], m_mask ? &*m_mask : nullptr);
         m_ptr_node->update(m_address, 0, &m_mem[0]);
     }
 }
+
+void Pointer::clear_rtti_cache() {
+    std::unique_lock _{s_rtti_lock};
+    s_rtti_types.clear();
+}
+
+sdkgenny::Type* Pointer::pointee() const {
+    return m_downcast != nullptr ? m_downcast : m_ptr->to();
+}
+
+void Pointer::fetch_rtti(uintptr_t address) {
+    auto vtable = address != 0 ? m_process.read_pointer(address) : std::nullopt;
+
+    // Vtables live in modules. Checking that first keeps whatever else the pointer points to (and there's a lot of it)
+    // out of the cache.
+    if (!vtable || m_process.get_module_within(*vtable) == nullptr) {
+        m_rtti = {};
+        m_rtti_vtable = 0;
+        return;
+    }
+
+    // Still the same object (or at least the same type of one).
+    if (*vtable == m_rtti_vtable) {
+        return;
+    }
+
+    m_rtti_vtable = *vtable;
+
+    {
+        std::shared_lock _{s_rtti_lock};
+
+        if (auto it = s_rtti_types.find(*vtable); it != s_rtti_types.end()) {
+            m_rtti = it->second;
+            return;
+        }
+    }
+
+    m_rtti = {};
+    m_rtti.name = m_process.get_typename_from_vtable(*vtable);
+
+    if (m_rtti.name) {
+        m_rtti.type = find_struct(m_ptr, *m_rtti.name);
+    }
+
+    std::unique_lock _{s_rtti_lock};
+    s_rtti_types.try_emplace(*vtable, m_rtti);
+}
+
+sdkgenny::Struct* Pointer::find_struct(sdkgenny::Object* scope, const std::string& rtti_name) {
+    std::string_view name{rtti_name};
+
+    for (auto prefix : {"class "sv, "struct "sv, "union "sv}) {
+        if (name.starts_with(prefix)) {
+            name.remove_prefix(prefix.size());
+        }
+    }
+
+    auto ns = scope->owner<sdkgenny::Namespace>();
+
+    if (ns == nullptr) {
+        return nullptr;
+    }
+
+    while (auto owner = ns->owner<sdkgenny::Namespace>()) {
+        ns = owner;
+    }
+
+    // app::Player is app.Player, with scopes made into identifiers the same way RTTI exports name them.
+    auto scopes = split_scopes(std::string{name});
+    sdkgenny::Object* parent = ns;
+
+    for (size_t i = 0; i + 1 < scopes.size() && parent != nullptr; ++i) {
+        parent = parent->find<sdkgenny::Object>(to_identifier(scopes[i]));
+    }
+
+    auto last = to_identifier(scopes.back());
+
+    if (parent != nullptr) {
+        if (auto struct_ = parent->find<sdkgenny::Struct>(last)) {
+            return struct_;
+        }
+    }
+
+    // Otherwise go by the class name alone if it's unique.
+    std::unordered_set<sdkgenny::Struct*> structs{};
+    sdkgenny::Struct* found{};
+
+    ns->get_all_in_children<sdkgenny::Struct>(structs);
+
+    for (auto&& struct_ : structs) {
+        if (struct_->name() == last) {
+            if (found != nullptr) {
+                return nullptr;
+            }
+
+            found = struct_;
+        }
+    }
+
+    return found;
+}
+
+uint64_t Pointer::CountField::load(const std::byte* pointer_mem) const {
+    uint64_t count{};
+
+    memcpy(&count, pointer_mem + offset, size);
+
+    if (bit_size != 0) {
+        count = (count >> bit_offset) & ((1ull << bit_size) - 1);
+    }
+
+    return count;
+}
+
+std::optional<Pointer::CountField> Pointer::find_count_field(sdkgenny::Variable* var, const std::string& path) {
+    auto struct_ = var->owner<sdkgenny::Struct>();
+
+    if (struct_ == nullptr) {
+        return std::nullopt;
+    }
+
+    auto owner_size = struct_->size();
+    uintptr_t offset{};
+
+    // Walk the path through nested structs, eg. header.size.
+    for (size_t start = 0;;) {
+        auto end = path.find('.', start);
+        auto name = path.substr(start, end == std::string::npos ? std::string::npos : end - start);
+        std::vector<std::pair<uintptr_t, sdkgenny::Variable*>> variables{};
+
+        collect_variables(struct_, offset, variables);
+
+        auto it = std::find_if(variables.begin(), variables.end(), [&](auto&& v) { return v.second->name() == name; });
+
+        if (it == variables.end()) {
+            spdlog::warn("{}: count field {} not found", var->name(), path);
+            return std::nullopt;
+        }
+
+        auto [field_offset, field] = *it;
+
+        if (end == std::string::npos) {
+            auto size = field->size();
+
+            if (field->type()->is_a<sdkgenny::Struct>() || (size != 1 && size != 2 && size != 4 && size != 8) ||
+                field_offset + size > owner_size) {
+                spdlog::warn("{}: count field {} isn't an integer", var->name(), path);
+                return std::nullopt;
+            }
+
+            CountField count{};
+
+            count.offset = (intptr_t)field_offset - (intptr_t)var->offset();
+            count.size = size;
+            count.bit_offset = field->is_bitfield() ? field->bit_offset() : 0;
+            count.bit_size = field->is_bitfield() ? field->bit_size() : 0;
+            return count;
+        }
+
+        struct_ = dynamic_cast<sdkgenny::Struct*>(field->type());
+
+        if (struct_ == nullptr) {
+            spdlog::warn("{}: {} in count field {} isn't a struct", var->name(), name, path);
+            return std::nullopt;
+        }
+
+        offset = field_offset;
+        start = end + 1;
+    }
+}
+
+size_t Pointer::evict(size_t bytes_wanted) {
+    // Only buffers that haven't been displayed recently can be given back. refresh_memory runs every frame a pointer
+    // is displayed so anything on screen was used within the last frame.
+    if (m_mem.empty() || std::chrono::steady_clock::now() - m_last_used < 1s) {
+        return 0;
+    }
+
+    auto freed = m_mem.capacity();
+
+    m_mem.clear();
+    m_mem.shrink_to_fit();
+    m_mem_usage.set(0);
+
+    // Force a fresh read the next time we're expanded.
+    m_mem_refresh_time = {};
+
+    return freed;
+}
 } // namespace node
\ No newline at end of file
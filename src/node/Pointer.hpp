@@ -1,17 +1,25 @@
 #pragma once
 
 #include <chrono>
+#include <optional>
+#include <shared_mutex>
+#include <unordered_map>
 
+#include "../MemoryAccountant.hpp"
 #include "../Process.hpp"
 #include "Variable.hpp"
 
 namespace node {
-class Pointer : public Variable {
+class Pointer : public Variable, public MemoryAccountant::Evictable {
 public:
     Pointer(Config& cfg, Process& process, sdkgenny::Variable* var, Property& props);
+    ~Pointer() override;
 
     void display(uintptr_t address, uintptr_t offset, std::byte* mem) override;
     void update(uintptr_t address, uintptr_t offset, std::byte* mem) override;
+    void fetch(uintptr_t address, std::byte* mem, const Process::PageMask* mask) override;
+    void filter_text(std::vector<std::string_view>& out) override;
+    void for_each_child(const std::function<void(Base&)>& fn) override;
 
     auto is_collapsed(bool is_collapsed) {
         m_props["__collapsed"].set(is_collapsed);
@@ -19,6 +27,8 @@ public:
     }
     auto& is_collapsed() { return m_props["__collapsed"].as_bool(); }
 
+    void expand() override { is_collapsed() = false; }
+
     auto is_array(bool is_array) {
         m_props["__array"].set(is_array);
         return this;
@@ -31,21 +41,99 @@ public:
     }
     auto& array_count() { return m_props["__count"].as_int(); }
 
+    // Cap on a count bound to a field (see is_count_bound).
+    auto max_count(int max) {
+        m_props["__max"].set(max);
+        return this;
+    }
+    auto& max_count() { return m_props["__max"].as_int(); }
+
+    // Pointers marked with [[count:<field>]] (eg. T* data [[count:size]] or [[count:header.size]]) point to an array
+    // whose element count is read from a field of the struct they're in every refresh.
+    bool is_count_bound() const { return m_count_field.has_value(); }
+
+    // Where a bound count is relative to the pointer (it can come before it) and how big it is. Bitfields are masked
+    // out of the bytes they share (bit size 0 for fields that aren't).
+    struct CountField {
+        intptr_t offset{};
+        size_t size{};
+        size_t bit_offset{};
+        size_t bit_size{};
+
+        // Loads the count from the memory of the pointer it's bound to.
+        uint64_t load(const std::byte* pointer_mem) const;
+    };
+
+    static constexpr int default_max_count = 10000;
+
+    // Resolves the field path of a [[count:<field>]] binding from the struct var is in (eg. for a snapshot).
+    static std::optional<CountField> find_count_field(sdkgenny::Variable* var, const std::string& path);
+
+    // Forgets which struct every vtable resolved to. Call whenever the SDK is reparsed or the process changes.
+    static void clear_rtti_cache();
+
+    // The struct an RTTI name (eg. "class app::Player") refers to, searched for from the root namespace of scope.
+    static sdkgenny::Struct* find_struct(sdkgenny::Object* scope, const std::string& rtti_name);
+    static bool derives_from(sdkgenny::Struct* struct_, sdkgenny::Struct* base);
+
+    auto& mem() const { return m_mem; }
+    auto address() const { return m_address; }
+
+    // MemoryAccountant::Evictable
+    std::chrono::steady_clock::time_point last_used() const override { return m_last_used; }
+    size_t evict(size_t bytes_wanted) override;
+
 protected:
+    // What a vtable's RTTI name resolved to. type is the struct of the same name when there is one.
+    struct RttiType {
+        std::optional<std::string> name{};
+        sdkgenny::Struct* type{};
+    };
+
+    static std::shared_mutex s_rtti_lock;
+    static std::unordered_map<uintptr_t, RttiType> s_rtti_types;
+
     sdkgenny::Pointer* m_ptr{};
     std::vector<std::byte> m_mem{};
+    // Which pages of m_mem the last refresh could read (empty when it was all served from a prefetch).
+    std::optional<Process::PageMask> m_mask{};
+    MemoryAccountant::Usage m_mem_usage{MemoryAccountant::Category::PointerBuffers};
     std::chrono::steady_clock::time_point m_mem_refresh_time{};
+    std::chrono::steady_clock::time_point m_last_used{};
     uintptr_t m_address{};
 
     std::unique_ptr<Base> m_ptr_node{};
     std::unique_ptr<sdkgenny::Variable> m_proxy_var{};
 
+    std::optional<CountField> m_count_field{};
+    std::string m_count_path{};
+    // Count read in the last update (clamped to max_count) and the number of elements the array node was made for.
+    size_t m_count{};
+    size_t m_count_capacity{};
+
+    // The derived struct the object pointed to really is (when it has RTTI and a struct of that name derives from the
+    // declared one), and the type m_ptr_node was made for.
+    sdkgenny::Struct* m_downcast{};
+    // What the object pointed to was found to be by the last fetch (a copy, the cache can be cleared) and the vtable it
+    // was found from.
+    RttiType m_rtti{};
+    uintptr_t m_rtti_vtable{};
+    // The RTTI type derives_from was last checked for and whether it derives from the declared type.
+    sdkgenny::Struct* m_derives_checked{};
+    bool m_derives{};
+    sdkgenny::Type* m_node_type{};
+    size_t m_node_type_size{};
+
     std::string m_value_str{};
     std::string m_address_str{};
 
     bool m_is_hovered{};
 
     void refresh_memory();
+    // The type displayed for the object pointed to.
+    sdkgenny::Type* pointee() const;
+    // Finds out what the object at address is into m_rtti.
+    void fetch_rtti(uintptr_t address);
 
     static void display_str(std::string& s, const std::string& str);
 };
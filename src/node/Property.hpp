@@ -32,5 +32,16 @@ struct Property {
 
     bool& as_bool() { return std::get<bool>(value); }
     int& as_int() { return std::get<int>(value); }
+
+    // Approximate number of bytes owned by this property and its children.
+    size_t memory_usage() const {
+        auto bytes = sizeof(Property);
+
+        for (auto&& [name, prop] : props) {
+            bytes += name.capacity() + prop.memory_usage();
+        }
+
+        return bytes;
+    }
 };
 } // namespace node
\ No newline at end of file
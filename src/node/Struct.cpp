@@ -1,9 +1,7 @@
 #include <fmt/format.h>
 #include <imgui.h>
 
-#include "Array.hpp"
-#include "Bitfield.hpp"
-#include "Pointer.hpp"
+#include "Factory.hpp"
 #include "Undefined.hpp"
 #include "UndefinedBitfield.hpp"
 
@@ -16,67 +14,37 @@ Struct::Struct(Config& cfg, Process& process, sdkgenny::Variable* var, Property&
 
     m_props["__collapsed"].set_default(true);
 
-    std::set<uintptr_t> bitfield_offsets{};
+    auto& layout = LayoutCache::layout(m_struct);
 
     // Build the node map.
-    auto make_node = [&](sdkgenny::Variable* var) -> std::unique_ptr<Base> {
-        auto&& props = m_props[var->name()];
-
-        if (var->type()->is_a<sdkgenny::Array>()) {
-            return std::make_unique<Array>(m_cfg, m_process, var, props);
-        } else if (var->type()->is_a<sdkgenny::Struct>()) {
-            return std::make_unique<Struct>(m_cfg, m_process, var, props);
-        } else if (var->type()->is_a<sdkgenny::Pointer>()) {
-            return std::make_unique<Pointer>(m_cfg, m_process, var, props);
-        } else if (var->is_bitfield()) {
-            return std::make_unique<Bitfield>(m_cfg, m_process, var, props);
-        } else {
-            return std::make_unique<Variable>(m_cfg, m_process, var, props);
-        }
-    };
-    std::function<void(uintptr_t, sdkgenny::Struct*)> add_vars = [&](uintptr_t offset, sdkgenny::Struct* s) {
-        auto parent_offset = offset;
-
-        for (auto&& parent : s->parents()) {
-            add_vars(parent_offset, parent);
-            parent_offset += parent->size();
-        }
-
-        for (auto&& var : s->get_all<sdkgenny::Variable>()) {
-            if (var->is_bitfield()) {
-                bitfield_offsets.emplace(offset + var->offset());
-            } else {
-                m_nodes.emplace(offset + var->offset(), make_node(var));
-            }
-        }
-    };
-
-    add_vars(0, m_struct);
+    for (auto&& member : layout.members) {
+        m_nodes.emplace(
+            member.offset, make_node(m_cfg, m_process, member.var, m_props[member.var->name()], member.kind));
+    }
 
     // Fill in all the bitfields (padding becomes UndefinedBitfield nodes).
-    for (auto offset : bitfield_offsets) {
+    for (auto&& group : layout.bitfields) {
+        auto offset = group.offset;
         auto last_bit = 0;
-        sdkgenny::Type* bitfield_type = nullptr;
 
-        for (auto&& [bit_offset, var] : m_struct->bitfield(offset)) {
-            if (bit_offset - last_bit > 0) {
+        for (auto&& field : group.fields) {
+            if (field.bit_offset - last_bit > 0) {
                 auto& props = m_props[fmt::format("pad_bitfield__{:x}_{:x}", offset, last_bit)];
-                m_nodes.emplace(offset, std::make_unique<UndefinedBitfield>(
-                                            m_cfg, m_process, props, var->size(), bit_offset - last_bit, last_bit));
+                m_nodes.emplace(offset, std::make_unique<UndefinedBitfield>(m_cfg, m_process, props, field.size,
+                                            field.bit_offset - last_bit, last_bit));
             }
 
-            m_nodes.emplace(offset, make_node(var));
+            m_nodes.emplace(offset, make_node(m_cfg, m_process, field.var, m_props[field.var->name()], field.kind));
 
-            last_bit = bit_offset + var->bit_size();
-            bitfield_type = var->type();
+            last_bit = field.bit_offset + field.bit_size;
         }
 
-        auto num_bits = bitfield_type->size() * CHAR_BIT;
+        auto num_bits = group.storage_size * CHAR_BIT;
 
         if (last_bit != num_bits) {
             auto bit_offset = num_bits;
             auto& props = m_props[fmt::format("pad_bitfield__{:x}_{:x}", offset, last_bit)];
-            m_nodes.emplace(offset, std::make_unique<UndefinedBitfield>(m_cfg, m_process, props, bitfield_type->size(),
+            m_nodes.emplace(offset, std::make_unique<UndefinedBitfield>(m_cfg, m_process, props, group.storage_size,
                                         bit_offset - last_bit, last_bit));
         }
     }
@@ -121,12 +89,12 @@ void Struct::display(uintptr_t address, uintptr_t offset, std::byte* mem) {
 
         m_is_hovered = ImGui::IsItemHovered();
 
-        if (is_collapsed() && !m_is_hovered) {
+        if (is_collapsed() && !m_is_hovered && !is_forced_open()) {
             return;
         }
     }
 
-    auto show_tooltip = is_collapsed() && m_is_hovered;
+    auto show_tooltip = is_collapsed() && m_is_hovered && !is_forced_open();
 
     if (show_tooltip) {
         ImGui::BeginTooltip();
@@ -175,9 +143,11 @@ void Struct::display(uintptr_t address, uintptr_t offset, std::byte* mem) {
 
             auto& node = it->second;
 
-            ImGui::PushID(node.get());
-            node->display(address + node_offset, offset + node_offset, &mem[node_offset]);
-            ImGui::PopID();
+            if (show_tooltip || is_shown(node.get())) {
+                ImGui::PushID(node.get());
+                node->display(address + node_offset, offset + node_offset, &mem[node_offset]);
+                ImGui::PopID();
+            }
 
             indentation_level = backup_indentation_level;
             node_size = node->size();
@@ -196,16 +166,54 @@ void Struct::update(uintptr_t address, uintptr_t offset, std::byte* mem) {
     m_display_str.clear();
 
     // RTTI
-    if (auto tn = m_process.get_typename(address); tn) {
-        fmt::format_to(std::back_inserter(m_display_str), "obj:{:s} ", *tn);
+    if (m_typename) {
+        fmt::format_to(std::back_inserter(m_display_str), "obj:{:s} ", *m_typename);
     }
 
     if (is_collapsed() && !m_is_hovered) {
         return;
     }
 
+    // The memory has already been read by the owning pointer node and everything else by fetch so formatting each child
+    // is independent of the others. Flatten the node map so the children can be split up and formatted in parallel.
+    m_update_order.clear();
+    m_update_order.reserve(m_nodes.size());
+
     for (auto&& [node_offset, node] : m_nodes) {
+        m_update_order.emplace_back(node_offset, node.get());
+    }
+
+    update_children(m_update_order.size(), [&](size_t i) {
+        auto [node_offset, node] = m_update_order[i];
         node->update(address + node_offset, offset + node_offset, &mem[node_offset]);
+    });
+}
+
+void Struct::fetch(uintptr_t address, std::byte* mem, const Process::PageMask* mask) {
+    Base::fetch(address, mem, mask);
+    m_typename = m_process.get_typename(address);
+
+    if (is_collapsed() && !m_is_hovered) {
+        return;
+    }
+
+    for (auto&& [node_offset, node] : m_nodes) {
+        node->fetch(address + node_offset, &mem[node_offset], mask);
+    }
+}
+
+void Struct::filter_text(std::vector<std::string_view>& out) {
+    if (!m_display_self) {
+        return;
+    }
+
+    Variable::filter_text(out);
+    out.emplace_back(m_display_str);
+}
+
+void Struct::for_each_child(const std::function<void(Base&)>& fn) {
+    for (auto&& [node_offset, node] : m_nodes) {
+        fn(*node);
     }
 }
 
@@ -224,7 +232,7 @@ void Struct::fill_space(uintptr_t last_offset, int delta) {
     auto end = last_offset + delta;
 
     for (auto offset = start; offset <= end; ++offset) {
-        if (offset % sizeof(uintptr_t) == 0 || offset == end) {
+        if (offset % m_process.pointer_size() == 0 || offset == end) {
             switch (offset - last_offset) {
             case 8:
                 add_undefined(last_offset, 8);
@@ -1,6 +1,8 @@
 #pragma once
 
 #include <map>
+#include <optional>
+#include <vector>
 
 #include "Variable.hpp"
 
@@ -11,6 +13,9 @@ public:
 
     void display(uintptr_t address, uintptr_t offset, std::byte* mem) override;
     void update(uintptr_t address, uintptr_t offset, std::byte* mem) override;
+    void fetch(uintptr_t address, std::byte* mem, const Process::PageMask* mask) override;
+    void filter_text(std::vector<std::string_view>& out) override;
+    void for_each_child(const std::function<void(Base&)>& fn) override;
 
     auto is_collapsed(bool is_collapsed) {
         m_props["__collapsed"].set(is_collapsed);
@@ -18,6 +23,8 @@ public:
     }
     auto& is_collapsed() { return m_props["__collapsed"].as_bool(); }
 
+    void expand() override { is_collapsed() = false; }
+
     auto display_self(bool display_self) {
         m_display_self = display_self;
         return this;
@@ -28,8 +35,10 @@ private:
     bool m_display_self{true};
     sdkgenny::Struct* m_struct{};
     std::multimap<uintptr_t, std::unique_ptr<Base>> m_nodes{};
+    std::vector<std::pair<uintptr_t, Base*>> m_update_order{};
     bool m_is_hovered{};
     std::string m_display_str{};
+    std::optional<std::string> m_typename{};
 
     void fill_space(uintptr_t last_offset, int delta);
 };
@@ -1,3 +1,5 @@
+#include <algorithm>
+
 #include <fmt/format.h>
 #include <imgui.h>
 
@@ -132,7 +134,7 @@ void Undefined::display(uintptr_t address, uintptr_t offset, std::byte* mem) {
 
         ImGui::BeginTooltip();
         indentation_level = -1;
-        g_preview_node->display(*(uintptr_t*)mem, 0, &mem[0]);
+        g_preview_node->display(m_process.load_pointer(mem), 0, &mem[0]);
         ImGui::EndTooltip();
 
         indentation_level = backup_indentation_level;
@@ -143,6 +145,38 @@ size_t Undefined::size() {
     return m_size;
 }
 
+void Undefined::fetch(uintptr_t address, std::byte* mem, const Process::PageMask* mask) {
+    Base::fetch(address, mem, mask);
+    m_typename.reset();
+    m_vtable_typename.reset();
+    m_pointee_typename.reset();
+    m_str.clear();
+
+    if (!m_readable || m_size != m_process.pointer_size()) {
+        return;
+    }
+
+    auto addr = m_process.load_pointer(mem);
+
+    m_typename = m_process.get_typename(address);
+
+    if (!m_typename) {
+        m_vtable_typename = m_process.get_typename_from_vtable(address);
+    }
+
+    m_pointee_typename = m_process.get_typename(addr);
+
+    // Only pointers into a module or an allocation get previewed as a string (see update).
+    auto is_pointer = m_process.get_module_within(addr) != nullptr ||
+                      std::any_of(m_process.allocations().begin(), m_process.allocations().end(),
+                          [addr](auto&& allocation) { return allocation.start <= addr && addr <= allocation.end; });
+
+    if (is_pointer) {
+        m_str.assign(256, '\0');
+        m_process.read(addr, m_str.data(), 255 * sizeof(char));
+    }
+}
+
 void Undefined::update(uintptr_t address, uintptr_t offset, std::byte* mem) {
     Base::update(address, offset, mem);
 
@@ -156,18 +190,18 @@ void Undefined::update(uintptr_t address, uintptr_t offset, std::byte* mem) {
         fmt::format_to(std::back_inserter(m_bytes_str), "{:02X}", *(uint8_t*)&mem[i]);
     }
 
-    if (m_size == sizeof(uintptr_t)) {
-        auto addr = *(uintptr_t*)mem;
+    if (m_size == m_process.pointer_size()) {
+        auto addr = m_process.load_pointer(mem);
 
         // RTTI
-        if (auto tn = m_process.get_typename(address); tn) {
-            fmt::format_to(std::back_inserter(m_preview_str), "obj:{:s} ", *tn);
-        } else if (auto tn = m_process.get_typename_from_vtable(address); tn) {
-            fmt::format_to(std::back_inserter(m_preview_str), "vtable:{:s} ", *tn);
-        } 
-
-        if (auto tn = m_process.get_typename(addr); tn) {
-            fmt::format_to(std::back_inserter(m_preview_str), "obj*:{:s} ", *tn);
+        if (m_typename) {
+            fmt::format_to(std::back_inserter(m_preview_str), "obj:{:s} ", *m_typename);
+        } else if (m_vtable_typename) {
+            fmt::format_to(std::back_inserter(m_preview_str), "vtable:{:s} ", *m_vtable_typename);
+        }
+
+        if (m_pointee_typename) {
+            fmt::format_to(std::back_inserter(m_preview_str), "obj*:{:s} ", *m_pointee_typename);
         }
 
         for (auto&& mod : m_process.modules()) {
@@ -185,10 +219,8 @@ void Undefined::update(uintptr_t address, uintptr_t offset, std::byte* mem) {
         }
 
         if (m_is_pointer) {
-            // See if it looks like its pointing to a string.
-            static std::string str{};
-            str.resize(256);
-            m_process.read(addr, str.data(), 255 * sizeof(char));
+            // See if it looks like its pointing to a string (fetch read it).
+            auto& str = m_str;
             str.resize(std::min<size_t>(256, strlen(str.data())));
 
             auto is_str = true;
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <optional>
+
 #include "Base.hpp"
 
 namespace node {
@@ -12,6 +14,7 @@ public:
     void display(uintptr_t address, uintptr_t offset, std::byte* mem) override;
     size_t size() override;
     void update(uintptr_t address, uintptr_t offset, std::byte* mem) override;
+    void fetch(uintptr_t address, std::byte* mem, const Process::PageMask* mask) override;
 
     auto size_override(int size) {
         m_props["__size"].set(size);
@@ -24,6 +27,12 @@ protected:
     size_t m_original_size{};
     std::string m_bytes_str{};
     std::string m_preview_str{};
+    std::string m_str{};
     bool m_is_pointer{};
+
+    // RTTI of the object at (or the vtable at) our address and of the object we point to, from the last fetch.
+    std::optional<std::string> m_typename{};
+    std::optional<std::string> m_vtable_typename{};
+    std::optional<std::string> m_pointee_typename{};
 };
 } // namespace node
\ No newline at end of file
@@ -73,15 +73,52 @@ void Variable::display(uintptr_t address, uintptr_t offset, std::byte* mem) {
     }
 }
 
+void Variable::filter_text(std::vector<std::string_view>& out) {
+    out.emplace_back(m_var->name());
+    out.emplace_back(m_var->type()->name());
+    out.emplace_back(m_value_str);
+}
+
 size_t Variable::size() {
     return m_size;
 }
 
+void Variable::fetch(uintptr_t address, std::byte* mem, const Process::PageMask* mask) {
+    Base::fetch(address, mem, mask);
+
+    if (!m_readable) {
+        return;
+    }
+
+    std::array<std::vector<std::string>*, 2> metadatas{&m_var->metadata(), &m_var->type()->metadata()};
+
+    for (auto&& metadata : metadatas) {
+        for (auto&& md : *metadata) {
+            if (md == "utf8*") {
+                m_utf8.resize(256);
+                m_process.read(m_process.load_pointer(mem), m_utf8.data(), 255 * sizeof(char));
+            } else if (md == "utf16*") {
+                m_utf16.resize(256);
+                m_process.read(m_process.load_pointer(mem), m_utf16.data(), 255 * sizeof(char16_t));
+                m_utf16.back() = L'\0';
+            } else if (md == "utf32*") {
+                m_utf32.resize(256);
+                m_process.read(m_process.load_pointer(mem), m_utf32.data(), 255 * sizeof(char32_t));
+            }
+        }
+    }
+}
+
 void Variable::update(uintptr_t address, uintptr_t offset, std::byte* mem) {
     Base::update(address, offset, mem);
 
     m_value_str.clear();
 
+    if (!m_readable) {
+        m_value_str = "?? ";
+        return;
+    }
+
     std::array<std::vector<std::string>*, 2> metadatas{&m_var->metadata(), &m_var->type()->metadata()};
 
     for (auto&& metadata : metadatas) {
@@ -107,15 +144,8 @@ void Variable::update(uintptr_t address, uintptr_t offset, std::byte* mem) {
             } else if (md == "f64") {
                 display_as<double>(m_value_str, mem);
             } else if (md == "utf8*") {
-                m_utf8.resize(256);
-                m_process.read(*(uintptr_t*)mem, m_utf8.data(), 255 * sizeof(char));
                 display_str(m_value_str, m_utf8);
             } else if (md == "utf16*") {
-                m_utf16.resize(256);
-                m_process.read(*(uintptr_t*)mem, m_utf16.data(), 255 * sizeof(char16_t));
-
-                m_utf16.back() = L'\0';
-
                 // if we don't do this then utf16to8 will throw an exception.
                 // todo: do for utf32?
                 const auto real_len = wcslen((wchar_t*)m_utf16.data());
@@ -131,9 +161,6 @@ void Variable::update(uintptr_t address, uintptr_t offset, std::byte* mem) {
 
                 display_str(m_value_str, utf8conv);
             } else if (md == "utf32*") {
-                m_utf32.resize(256);
-                m_process.read(*(uintptr_t*)mem, m_utf32.data(), 255 * sizeof(char32_t));
-
                 std::string utf32conv{};
 
                 try {
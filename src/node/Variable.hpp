@@ -14,6 +14,8 @@ public:
     void display(uintptr_t address, uintptr_t offset, std::byte* mem) override;
     size_t size() override;
     void update(uintptr_t address, uintptr_t offset, std::byte* mem) override;
+    void fetch(uintptr_t address, std::byte* mem, const Process::PageMask* mask) override;
+    void filter_text(std::vector<std::string_view>& out) override;
 
 protected:
     sdkgenny::Variable* m_var{};
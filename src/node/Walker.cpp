@@ -0,0 +1,187 @@
+#include <algorithm>
+
+#include <fmt/format.h>
+
+#include "../Utility.hpp"
+
+#include "Walker.hpp"
+
+namespace node {
+namespace {
+// Resolves a link given as a field name of element (or as an offset) to an offset into element.
+std::optional<uintptr_t> link_offset(sdkgenny::Struct* element, const std::string& link) {
+    std::vector<std::pair<uintptr_t, sdkgenny::Variable*>> variables{};
+    collect_variables(element, 0, variables);
+
+    for (auto&& [offset, var] : variables) {
+        if (var->name() == link) {
+            return offset;
+        }
+    }
+
+    try {
+        return std::stoull(link, nullptr, 0);
+    } catch (...) {
+        return std::nullopt;
+    }
+}
+
+std::vector<std::string> split(const std::string& s, char delim) {
+    std::vector<std::string> out{};
+    size_t start{};
+
+    for (auto end = s.find(delim); end != std::string::npos; end = s.find(delim, start)) {
+        out.emplace_back(s.substr(start, end - start));
+        start = end + 1;
+    }
+
+    out.emplace_back(s.substr(start));
+    return out;
+}
+} // namespace
+
+Walker::Walker(Config& cfg, Process& process, sdkgenny::Variable* var, Property& props)
+    : Elements{cfg, process, var, props, 10000} {
+    auto links = parse_links(var);
+    assert(links);
+
+    m_links = *links;
+    m_num_heads = var->size() / sizeof(uintptr_t);
+    m_element_type = m_links.element;
+    m_element_size = std::max<size_t>(m_links.element->size(), 1);
+}
+
+bool Walker::is_walker(sdkgenny::Variable* var) {
+    return parse_links(var).has_value();
+}
+
+std::optional<Walker::Links> Walker::parse_links(sdkgenny::Variable* var) {
+    // The variable must be a pointer to a struct or an array of them.
+    auto type = var->type();
+
+    if (auto arr = dynamic_cast<sdkgenny::Array*>(type)) {
+        type = arr->of();
+    }
+
+    auto ptr = dynamic_cast<sdkgenny::Pointer*>(type);
+
+    if (ptr == nullptr) {
+        return std::nullopt;
+    }
+
+    auto element = dynamic_cast<sdkgenny::Struct*>(ptr->to());
+
+    if (element == nullptr) {
+        return std::nullopt;
+    }
+
+    for (auto&& md : var->metadata()) {
+        auto params = split(md, ':');
+        Links links{};
+        links.element = element;
+
+        if (params[0] == "list" && params.size() == 2) {
+            links.kind = Kind::List;
+        } else if (params[0] == "tree" && params.size() == 3) {
+            links.kind = Kind::Tree;
+        } else {
+            continue;
+        }
+
+        auto first = link_offset(element, params[1]);
+        auto second = links.kind == Kind::Tree ? link_offset(element, params[2]) : first;
+
+        if (!first || !second || *first + sizeof(uintptr_t) > element->size() ||
+            *second + sizeof(uintptr_t) > element->size()) {
+            return std::nullopt;
+        }
+
+        links.first = *first;
+        links.second = *second;
+
+        return links;
+    }
+
+    return std::nullopt;
+}
+
+std::vector<uintptr_t> Walker::load_heads(std::byte* mem) const {
+    std::vector<uintptr_t> heads(m_num_heads);
+
+    // The heads are laid out by the sdk, whose pointers are always our size, but hold the target's pointers.
+    m_process.with_pointer([&]<typename Ptr>(Ptr) {
+        for (size_t i = 0; i < m_num_heads; ++i) {
+            heads[i] = Ptr::load(mem + i * sizeof(uintptr_t));
+        }
+    });
+
+    return heads;
+}
+
+void Walker::walk(std::vector<uintptr_t> heads) {
+    m_truncated = false;
+
+    if (m_links.kind == Kind::List) {
+        m_found = walk_lists(heads, m_links.first, 0, SIZE_MAX);
+    } else {
+        m_found = walk_trees(heads, m_links.first, m_links.second, 0, SIZE_MAX);
+    }
+
+    m_walked_heads = std::move(heads);
+    m_walked_max = max_elements();
+}
+
+void Walker::fetch(uintptr_t address, std::byte* mem, const Process::PageMask* mask) {
+    Base::fetch(address, mem, mask);
+
+    // Walking can take many round trips so it's only done while the node is open.
+    if (is_collapsed()) {
+        m_walked_heads.clear();
+        return;
+    }
+
+    if (auto heads = load_heads(mem); heads != m_walked_heads || max_elements() != m_walked_max) {
+        walk(std::move(heads));
+    }
+
+    auto start = std::min((size_t)start_element(), m_found.size());
+    auto end = std::min(start + num_elements_displayed(), m_found.size());
+
+    m_element_addresses.assign(m_found.begin() + start, m_found.begin() + end);
+
+    // The page is walked again from where it started last time. It stops early at the end of its list when the page
+    // spans more than one, the rest of the page then comes from the last walk.
+    if (m_links.kind == Kind::List && start < end) {
+        auto page = walk_lists({m_found[start]}, m_links.first, 0, end - start);
+
+        if (!std::equal(page.begin(), page.end(), m_element_addresses.begin())) {
+            std::copy(page.begin(), page.end(), m_element_addresses.begin());
+            m_walked_heads.clear();
+        }
+    }
+
+    fetch_elements();
+}
+
+std::vector<uintptr_t> Walker::find_all_elements(uintptr_t address, std::byte* mem) {
+    walk(load_heads(mem));
+    return m_found;
+}
+
+void Walker::update(uintptr_t address, uintptr_t offset, std::byte* mem) {
+    Base::update(address, offset, mem);
+    m_value_str.clear();
+
+    if (is_collapsed()) {
+        return;
+    }
+
+    fmt::format_to(std::back_inserter(m_value_str), "count={} ", m_found.size());
+
+    if (m_truncated) {
+        m_value_str += "(truncated) ";
+    }
+
+    update_elements();
+}
+} // namespace node
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <optional>
+
+#include "Elements.hpp"
+
+namespace node {
+// Walks intrusive linked lists and binary trees hanging off a pointer (or an array of pointers, eg. hash buckets). The
+// links are given with metadata naming fields (or offsets) of the struct pointed to:
+//
+//     Entry* head [[list:next]]
+//     Entry* buckets[64] [[list:next]]
+//     Node* root [[tree:left:right]]
+//
+// Every list (or tree level) is advanced in the same read_batch so the number of round trips is the length of the
+// longest list (or the height of the tallest tree) rather than the number of elements. Only the displayed page of
+// elements gets nodes.
+//
+// Everything is walked when the node is opened and whenever a head changes. Other refreshes only walk the displayed
+// page of a list again (and everything next time if the page changed). Trees are only walked again then.
+class Walker : public Elements {
+public:
+    enum class Kind {
+        List,
+        Tree
+    };
+
+    Walker(Config& cfg, Process& process, sdkgenny::Variable* var, Property& props);
+
+    static bool is_walker(sdkgenny::Variable* var);
+
+    void update(uintptr_t address, uintptr_t offset, std::byte* mem) override;
+    void fetch(uintptr_t address, std::byte* mem, const Process::PageMask* mask) override;
+    std::vector<uintptr_t> find_all_elements(uintptr_t address, std::byte* mem) override;
+
+protected:
+    struct Links {
+        Kind kind{};
+        sdkgenny::Struct* element{};
+        // next for lists, left for trees.
+        uintptr_t first{};
+        uintptr_t second{};
+    };
+
+    Links m_links{};
+    size_t m_num_heads{};
+
+    // Every element found, in list (or in-order) order, and the heads and max_elements() they were walked with.
+    std::vector<uintptr_t> m_found{};
+    std::vector<uintptr_t> m_walked_heads{};
+    int m_walked_max{};
+
+    static std::optional<Links> parse_links(sdkgenny::Variable* var);
+
+    std::vector<uintptr_t> load_heads(std::byte* mem) const;
+    // Walks every list (or tree) from heads into m_found.
+    void walk(std::vector<uintptr_t> heads);
+};
+} // namespace node